@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "GpuTimer.h"
+
+// AutoExposure adapts the exposure to the scene's average luminance.
+// A fullscreen pass (owned by PostProcessor) writes log(luminance) of the HDR
+// scene into a small power-of-two target; Reduce() mips it down to a single
+// texel whose value is the average log luminance, and copies that texel into
+// a pixel-pack buffer followed by a fence. Update() polls the fences without
+// waiting, so the result arrives a couple of frames late but the CPU never
+// stalls on the GPU. If every buffer is still in flight the frame's reduction
+// is skipped instead.
+class AutoExposure
+{
+public:
+    static constexpr int SIZE = 64;              // Luminance target (mip chain down to 1x1)
+    static constexpr int READBACK_COUNT = 3;     // Pack buffers in flight
+
+    AutoExposure();
+    ~AutoExposure();
+
+    void Initialize();
+    void Cleanup();
+    bool IsInitialized() const { return initialized; }
+
+    // Target for the log-luminance pass (SIZE x SIZE, R16F)
+    unsigned int GetFramebuffer() const { return fbo; }
+    unsigned int GetTexture() const { return texture; }
+
+    // Timer bracket for the luminance pass plus the reduction
+    void BeginMeasure() { gpuTimer.Begin(); }
+    void EndMeasure() { gpuTimer.End(); }
+    // Average the target on the GPU and queue the asynchronous readback
+    void Reduce();
+
+    // Collect finished readbacks and move the exposure toward the target
+    void Update(float deltaTime);
+
+    // Exposure that maps the average luminance to the key value
+    float GetExposure() const { return exposure; }
+    float GetAverageLuminance() const { return averageLuminance; }
+    void SetKeyValue(float key) { keyValue = key; }
+    // Adaptation rate in 1/seconds (larger = faster)
+    void SetAdaptationSpeed(float speed) { adaptationSpeed = speed; }
+
+    // Cost, measured separately: GPU time of pass + reduction, CPU time of
+    // polling and mapping, and reductions skipped because the ring was full
+    double GetGpuMs() const { return gpuTimer.GetLastMs(); }
+    double GetReadbackCpuMs() const { return readbackCpuMs; }
+    int GetSkippedReductions() const { return skippedReductions; }
+    // Frames between queuing a readback and reading it
+    int GetReadbackLatency() const { return readbackLatency; }
+
+private:
+    unsigned int texture;
+    unsigned int fbo;
+    int topLevel;
+    unsigned int packBuffers[READBACK_COUNT];
+    GLsync fences[READBACK_COUNT];
+    int issuedFrame[READBACK_COUNT];
+    int current;
+    int frame;
+    bool initialized;
+
+    float keyValue;
+    float adaptationSpeed;
+    float averageLuminance;
+    float targetExposure;
+    float exposure;
+    bool hasResult;
+
+    GpuTimer gpuTimer;
+    double readbackCpuMs;
+    int skippedReductions;
+    int readbackLatency;
+
+    void Collect(int index);
+};
@@ -3,6 +3,43 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
+#include <cstddef>
+
+// Per-instance data read by building.vert / building_shadow.vert
+// (attribute locations 3-5, advanced once per instance)
+struct BuildingInstance
+{
+    glm::vec3 position;
+    glm::vec3 scale;
+    float textureIndex;     // Facade texture array layer
+};
+
+// PackInstances writes records as 7 consecutive floats
+static_assert(sizeof(BuildingInstance) == 7 * sizeof(float), "BuildingInstance must be tightly packed");
+
+// Buildings stored as structure-of-arrays (one array per component).
+// City generation writes this directly; GPU records and cull bounds
+// are derived from it in bulk.
+struct BuildingSoA
+{
+    std::vector<float> px, py, pz;     // Centre position
+    std::vector<float> sx, sy, sz;     // Full size (unit cube scale)
+    std::vector<float> tex;            // Facade texture array layer
+    
+    void Clear();
+    void Reserve(size_t count);
+    void Push(const glm::vec3& position, const glm::vec3& scale, float textureLayer);
+    size_t Size() const { return px.size(); }
+};
+
+// CPU-side RGBA8 image, one layer of the facade texture array
+struct FacadeImage
+{
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
 
 // Building represents a textured cube with UV mapping for city generation
 class Building
@@ -10,17 +47,32 @@ class Building
 public:
     glm::vec3 position;
     glm::vec3 scale;
-    unsigned int textureID;
+    unsigned int textureIndex;  // Layer in the city's facade texture array
     
-    Building(const glm::vec3& pos, const glm::vec3& scl, unsigned int texID);
+    Building(const glm::vec3& pos, const glm::vec3& scl, unsigned int texIndex);
     
     glm::mat4 GetModelMatrix() const;
+    BuildingInstance GetInstanceData() const;
+    
+    // Emit one BuildingInstance per building of `soa` into `out`
+    // (must hold soa.Size() records). Transposes 4 buildings per step with SSE.
+    static void PackInstances(const BuildingSoA& soa, BuildingInstance* out);
     
     // Static methods for shared geometry
     static void InitializeGeometry();
     static void CleanupGeometry();
-    static void RenderGeometry();
-    static unsigned int LoadBuildingTexture(const char* path);
+    
+    // Draw `instanceCount` cubes reading BuildingInstance records from
+    // `instanceVBO`, starting at record `firstInstance`
+    static void RenderInstanced(unsigned int instanceVBO, size_t firstInstance, size_t instanceCount);
+    
+    // Facade textures: decode to RGBA, then pack every layer into one
+    // GL_TEXTURE_2D_ARRAY at a common resolution with a full mip chain
+    static bool LoadBuildingImage(const char* path, FacadeImage& image);
+    static FacadeImage ResizeImage(const FacadeImage& src, int width, int height);
+    static unsigned int CreateFacadeTextureArray(const std::vector<FacadeImage>& layers);
+    
+    static constexpr int MAX_FACADE_RESOLUTION = 1024;
     
 private:
     static unsigned int VAO, VBO;
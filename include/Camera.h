@@ -3,6 +3,13 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+// Frustum planes as (normal, d) with dot(normal, p) + d >= 0 inside.
+// Order: left, right, bottom, top, near, far
+struct FrustumPlanes
+{
+    glm::vec4 planes[6];
+};
+
 class Camera
 {
 public:
@@ -22,6 +29,13 @@ public:
     float MouseSensitivity;
     float Zoom;
 
+    // Sub-pixel projection offset in NDC for temporal upsampling (zero = none)
+    glm::vec2 Jitter;
+
+    // Length of the jitter sequence; enough samples to cover each output
+    // pixel about four times at half render resolution
+    static constexpr unsigned int JITTER_PHASES = 16;
+
     // Constructor with vectors
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 3.0f),
            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f),
@@ -34,6 +48,20 @@ public:
     // Returns the projection matrix
     glm::mat4 GetProjectionMatrix(float aspectRatio, float near = 0.1f, float far = 100.0f) const;
 
+    // Projection matrix shifted by Jitter (the scene pass uses this one;
+    // culling and reprojection use the unjittered matrix)
+    glm::mat4 GetJitteredProjectionMatrix(float aspectRatio, float near = 0.1f, float far = 100.0f) const;
+
+    // Set Jitter to sample frameIndex of a Halton(2,3) sequence, within one
+    // pixel of a width x height render target
+    void SetJitterSample(unsigned int frameIndex, unsigned int width, unsigned int height);
+
+    // Extract normalized frustum planes from a (projection * view) matrix
+    static FrustumPlanes ExtractFrustumPlanes(const glm::mat4& viewProjection);
+
+    // Frustum planes of this camera for the given projection parameters
+    FrustumPlanes GetFrustumPlanes(float aspectRatio, float near = 0.1f, float far = 100.0f) const;
+
     // Process mouse movement
     void ProcessMouseMovement(float xoffset, float yoffset, bool constrainPitch = true);
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Building.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Result of one background chunk generation job
+struct CompletedChunk
+{
+    int chunkX;
+    int chunkZ;
+    unsigned int generation;  // City generation the job was issued for
+    BuildingSoA buildings;
+};
+
+// ChunkStreamer runs chunk generation on worker threads.
+// Requests go through a small mutex-protected queue (workers sleep on it);
+// finished chunks are pushed onto a lock-free stack so the render thread
+// can collect them without ever blocking on a worker.
+class ChunkStreamer
+{
+public:
+    using GenerateFn = std::function<BuildingSoA(int chunkX, int chunkZ, int seed)>;
+
+    ChunkStreamer(GenerateFn generate, unsigned int workerCount = 0);
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    // Render thread: queue a chunk for generation
+    void Request(int chunkX, int chunkZ, int seed, unsigned int generation);
+
+    // Render thread: drop queued (not yet started) requests matching the predicate
+    void CancelPending(const std::function<bool(int chunkX, int chunkZ)>& shouldCancel);
+
+    // Render thread: move up to maxCount completed chunks into `out`
+    size_t PollCompleted(std::vector<CompletedChunk>& out, size_t maxCount);
+
+    size_t GetQueuedCount() const;
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    struct Job
+    {
+        int chunkX;
+        int chunkZ;
+        int seed;
+        unsigned int generation;
+    };
+
+    // Intrusive node of the lock-free completion stack
+    struct CompletedNode
+    {
+        CompletedChunk chunk;
+        CompletedNode* next;
+    };
+
+    GenerateFn generateChunk;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex jobMutex;
+    std::condition_variable jobAvailable;
+    std::deque<Job> jobs;
+    bool stopping;
+
+    // Multi-producer (workers) / single-consumer (render thread) stack
+    std::atomic<CompletedNode*> completedHead;
+
+    // Consumer-side FIFO of results already taken off the stack
+    std::deque<CompletedChunk> ready;
+
+    void WorkerLoop();
+    void PushCompleted(CompletedNode* node);
+};
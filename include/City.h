@@ -1,20 +1,41 @@
 #pragma once
 
 #include "Building.h"
+#include "ChunkStreamer.h"
+#include "FrustumCuller.h"
+#include "Shader.h"
+#include <cstdint>
 #include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <glm/glm.hpp>
 
+// Per-frame culling statistics (shown on the HUD)
+struct CityCullStats
+{
+    size_t chunksTested = 0;
+    size_t chunksCulled = 0;
+    size_t buildingsTested = 0;   // Buildings that needed a per-box test
+    size_t buildingsVisible = 0;
+    size_t buildingsCulled = 0;
+};
+
 class City
 {
 public:
     City();
     ~City();
     
-    void Initialize(unsigned int buildingShader);
+    void Initialize();
     void Generate(int seed = 42);
-    void Render(const glm::mat4& view, const glm::mat4& projection, 
-                const glm::mat4& lightSpaceMatrix, const glm::vec3& cameraPos);
-    void RenderShadow(const glm::mat4& lightSpaceMatrix, unsigned int shadowShader);
+    // Camera and light state come from the FrameData UBO; view and
+    // projection are only needed here for culling
+    void Render(const glm::mat4& view, const glm::mat4& projection, const Shader& buildingShader);
+    // Draw the set the last Render() culled and streamed again, e.g. the lit
+    // pass after a depth prepass in the same frame (no culling, no upload)
+    void RenderVisible(const Shader& buildingShader);
+    void RenderShadow(const glm::mat4& lightSpaceMatrix, const Shader& shadowShader);
     void UpdateChunks(const glm::vec3& cameraPos);
     void Cleanup();
     
@@ -22,24 +43,97 @@ public:
     void SetEnabled(bool enable) { enabled = enable; }
     void ToggleEnabled() { enabled = !enabled; }
     
+    // Chunk streaming: chunks within `radius` of the camera chunk are generated
+    // in the background, chunks beyond radius + EVICT_MARGIN are dropped
+    void SetStreamingRadius(int radius);
+    int GetStreamingRadius() const { return streamingRadius; }
+    
+    // Frustum culling: chunks are tested first, then the buildings of chunks
+    // that straddle the frustum are tested in SIMD batches
+    bool IsCullingEnabled() const { return cullingEnabled; }
+    void SetCullingEnabled(bool enable) { cullingEnabled = enable; }
+    void ToggleCulling() { cullingEnabled = !cullingEnabled; }
+    const CityCullStats& GetCullStats() const { return cullStats; }
+    const CityCullStats& GetShadowCullStats() const { return shadowCullStats; }
+    
+    size_t GetBuildingCount() const { return instanceCount; }
+    size_t GetResidentChunkCount() const { return chunks.size(); }
+    size_t GetPendingChunkCount() const { return pendingChunks.size(); }
+    // Bumped whenever the uploaded building set changes (cached shadows key on it)
+    unsigned int GetContentRevision() const { return contentRevision; }
+    // World AABB of all resident buildings (updated with the instance upload)
+    const glm::vec3& GetBoundsMin() const { return boundsMin; }
+    const glm::vec3& GetBoundsMax() const { return boundsMax; }
+    
 private:
-    std::vector<Building> buildings;
-    std::vector<unsigned int> buildingTextures;
-    unsigned int shaderProgram;
+    struct CityChunk
+    {
+        int chunkX;
+        int chunkZ;
+        BuildingSoA buildings;                    // Authoritative storage
+        std::vector<BuildingInstance> instances;  // Packed GPU records, cached until the chunk changes
+        BoundsSoA bounds;                         // Per-building AABBs for the SIMD test
+        glm::vec3 boundsCenter;                   // Whole-chunk AABB
+        glm::vec3 boundsExtent;
+    };
+    
+    std::unordered_map<long long, CityChunk> chunks;  // Resident chunks, keyed by ChunkKey
+    std::unordered_set<long long> pendingChunks;      // Requested, not yet integrated
+    std::unique_ptr<ChunkStreamer> streamer;
+    
+    unsigned int facadeTextureArray;  // GL_TEXTURE_2D_ARRAY, one layer per facade
+    unsigned int facadeLayerCount;
+    unsigned int instanceVBO;
+    size_t instanceCount;
+    bool instancesDirty;
+    unsigned int contentRevision;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    
+    // Visible subset, rebuilt and streamed every frame
+    unsigned int visibleInstanceVBO;
+    std::vector<BuildingInstance> visibleInstances;
+    std::vector<uint32_t> visibleIndices;
+    bool cullingEnabled;
+    CityCullStats cullStats;
+    
+    // Shadow casters that can land in the light's volume, streamed every frame
+    unsigned int shadowInstanceVBO;
+    std::vector<BuildingInstance> shadowInstances;
+    CityCullStats shadowCullStats;
     bool enabled;
     bool initialized;
     
+    int citySeed;
+    unsigned int generation;   // Bumped by Generate() so stale worker results are dropped
+    int streamingRadius;
+    int centerChunkX, centerChunkZ;
+    bool hasCenter;
+    
     // City generation parameters
     static constexpr int GRID_SIZE = 10;      // Buildings per chunk side
     static constexpr float BLOCK_SIZE = 4.0f;  // Size of each block
     static constexpr float ROAD_WIDTH = 2.0f;  // Width of roads
     static constexpr float MIN_HEIGHT = 3.0f;
     static constexpr float MAX_HEIGHT = 15.0f;
-    static constexpr int CHUNK_RADIUS = 2;     // Chunks to render around camera
+    static constexpr int CHUNK_RADIUS = 2;     // Default chunks to stream around camera
+    static constexpr int EVICT_MARGIN = 1;     // Hysteresis before a chunk is evicted
+    static constexpr size_t MAX_CHUNKS_PER_FRAME = 4;  // Integration budget per frame
     
-    void GenerateChunk(int chunkX, int chunkZ, int seed);
+    // Pure function of its arguments - called from worker threads
+    BuildingSoA GenerateChunk(int chunkX, int chunkZ, int seed) const;
+    void IntegrateChunk(CompletedChunk&& completed);
     void LoadBuildingTextures();
-    unsigned int GetRandomTexture(int seed) const;
-    float GetRandomHeight(int seed) const;
+    void UploadInstances();
+    void CullInstances(const glm::vec4* planes, int planeCount, 
+                       std::vector<BuildingInstance>& out, CityCullStats& stats);
+    static void StreamInstances(unsigned int& vbo, const std::vector<BuildingInstance>& instances);
+    unsigned int GetRandomTexture(uint32_t seed) const;
+    float GetRandomHeight(uint32_t seed) const;
     bool IsRoad(int x, int z) const;
+    
+    static long long ChunkKey(int chunkX, int chunkZ);
+    // Per-building seed: FNV-1a of (city seed, chunk key, x, z), defined for any chunk coordinate
+    static uint32_t BuildingSeed(int baseSeed, int chunkX, int chunkZ, int x, int z);
+    int ChunkDistance(int chunkX, int chunkZ) const;
 };
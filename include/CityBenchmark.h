@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+// CPU-only microbenchmark of the per-frame city instance work.
+// Compares the old per-building GetModelMatrix path against the SoA pack
+// kernel, the cached copy and the SIMD frustum cull. No GL context needed.
+// Run with: OpenGLProject --bench-city [buildingCount]
+int RunCityBenchmark(size_t buildingCount, int frames = 100);
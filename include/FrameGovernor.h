@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// One rung of the governor's quality ladder
+struct QualityLevel
+{
+    float renderScale;          // Fraction of the window size the HDR scene target uses
+    int maxPcfTaps;             // Largest PCF kernel allowed (the F10 choice is capped to it)
+    int bloomLevels;            // Dual-filter bloom mip levels
+    int shadowResolutionShift;  // Shadow layers are the base resolution >> shift
+    const char* name;
+};
+
+// FrameGovernor holds a target GPU frame time by stepping through a fixed
+// ladder of quality levels. The whole frame is bracketed with GL_TIMESTAMP
+// queries (read a few frames late, like GpuTimer; timestamps do not conflict
+// with the TIME_ELAPSED spans nested inside the frame). Every WINDOW_FRAMES
+// measurements the average is compared with the target: above it by more than
+// the margin drops one level at once, while raising quality needs
+// UPGRADE_WINDOWS consecutive windows well below it, so a level that only
+// just fits is kept instead of oscillating.
+class FrameGovernor
+{
+public:
+    static constexpr int QUERY_COUNT = 4;
+    static constexpr int LEVEL_COUNT = 6;
+    static constexpr int WINDOW_FRAMES = 30;
+    static constexpr int UPGRADE_WINDOWS = 2;
+
+    FrameGovernor();
+    ~FrameGovernor();
+
+    void Initialize();
+    void Cleanup();
+
+    // First and last GPU commands of the frame
+    void BeginFrame();
+    void EndFrame();
+
+    // Disabled: measurement continues but the settings stay at full quality
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return enabled; }
+
+    void SetTargetMs(double ms) { targetMs = ms; }
+    double GetTargetMs() const { return targetMs; }
+
+    int GetLevel() const { return enabled ? level : 0; }
+    const QualityLevel& GetSettings() const { return LEVELS[GetLevel()]; }
+
+    // Most recent frame and the last completed window
+    double GetLastMs() const { return lastMs; }
+    double GetWindowAverageMs() const { return windowAverageMs; }
+
+private:
+    static const QualityLevel LEVELS[LEVEL_COUNT];
+
+    unsigned int queries[QUERY_COUNT * 2];  // Begin/end timestamp pairs
+    bool pending[QUERY_COUNT];
+    bool discard[QUERY_COUNT];
+    int current;
+    bool initialized;
+
+    bool enabled;
+    double targetMs;
+    int level;
+
+    double lastMs;
+    double windowTotalMs;
+    int windowSamples;
+    double windowAverageMs;
+    int fastWindows;
+
+    void Collect(int index);
+    void Evaluate();
+    void ChangeLevel(int newLevel);
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "RenderTargetPool.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// FrameGraph describes a sequence of fullscreen passes by the targets they
+// read and write. It is rebuilt every frame (a handful of passes, so this is
+// cheap) and then compiled:
+//   - culling: walking backwards from the targets marked as outputs, a pass
+//     survives only if something downstream reads what it writes;
+//   - lifetimes: each transient target lives from the first to the last
+//     surviving pass that touches it;
+//   - aliasing: targets are acquired from the RenderTargetPool in pass order
+//     and released after their last use, so targets with the same size and
+//     format and disjoint lifetimes share one texture.
+// A pass that both reads and writes a target (additive blending) lists it in
+// both sets. Imported resources (the scene HDR target, the backbuffer) are
+// owned elsewhere and never pooled.
+class FrameGraph
+{
+public:
+    using ResourceId = int;
+    using PassFn = std::function<void(FrameGraph& graph)>;
+
+    struct Stats
+    {
+        int passCount;
+        int culledPasses;
+        int transientTargets;   // Targets declared by surviving passes
+        int physicalTargets;    // Pool textures they were mapped onto
+        size_t transientBytes;  // Memory without aliasing
+        size_t physicalBytes;   // Memory actually used this frame
+    };
+
+    FrameGraph();
+
+    // Start describing a new frame
+    void Reset();
+
+    ResourceId CreateTarget(const char* name, const RenderTargetDesc& desc);
+    ResourceId Import(const char* name, unsigned int texture, unsigned int fbo, unsigned int width, unsigned int height);
+    int AddPass(const char* name, std::vector<ResourceId> inputs, std::vector<ResourceId> outputs, PassFn execute);
+    void MarkOutput(ResourceId resource);
+
+    // Cull, compute lifetimes and assign pool targets; logs when the result changes
+    void Compile();
+    // Run the surviving passes in order, then hand every target back to the pool
+    void Execute();
+
+    bool IsPassActive(int pass) const { return passes[pass].active; }
+
+    // Valid inside pass callbacks
+    unsigned int GetTexture(ResourceId resource) const;
+    unsigned int GetWidth(ResourceId resource) const { return resources[resource].width; }
+    unsigned int GetHeight(ResourceId resource) const { return resources[resource].height; }
+    // Bind the resource's framebuffer and set the viewport to its size
+    void BindOutput(ResourceId resource) const;
+
+    const Stats& GetStats() const { return stats; }
+    const RenderTargetPool& GetPool() const { return pool; }
+    void Cleanup();
+
+private:
+    struct Resource
+    {
+        std::string name;
+        RenderTargetDesc desc;
+        bool imported;
+        unsigned int texture;   // Imported only
+        unsigned int fbo;
+        unsigned int width, height;
+        bool output;
+        int firstPass, lastPass;
+        int poolIndex;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        std::vector<ResourceId> inputs;
+        std::vector<ResourceId> outputs;
+        PassFn execute;
+        bool active;
+    };
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    RenderTargetPool pool;
+    Stats stats;
+    Stats lastReported;
+};
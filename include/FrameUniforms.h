@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// CPU mirror of the std140 "FrameData" uniform block declared in model,
+// building and skybox shaders. Member order and padding must match the
+// GLSL declaration exactly (vec3s are stored as vec4).
+struct FrameData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 lightSpaceMatrices[4];   // One per shadow cascade (ShadowMap::MAX_CASCADES)
+    glm::vec4 viewPos;                 // xyz
+    glm::vec4 dirLightDir;             // xyz
+    glm::vec4 dirLightColor;           // xyz
+    glm::vec4 pointLightPos;           // xyz
+    glm::vec4 pointLightColor;         // xyz
+    glm::vec4 pointLightAttenuation;   // constant, linear, quadratic
+    glm::vec4 cascadeSplits;           // View-space far distance of each cascade
+    int cascadeCount;
+    float padding[3];
+};
+
+static_assert(sizeof(FrameData) == 512, "FrameData must match the std140 layout of the GLSL block");
+
+// FrameUniforms owns the per-frame uniform buffer. It is filled once per
+// frame and bound at a fixed binding point; every program that declares
+// the FrameData block is attached to that binding at link time.
+class FrameUniforms
+{
+public:
+    static constexpr unsigned int BINDING = 0;
+
+    FrameUniforms();
+    ~FrameUniforms();
+
+    // Call before loading shaders so their FrameData block gets bound
+    void Initialize();
+    void Update(const FrameData& data);
+    void Cleanup();
+
+private:
+    unsigned int ubo;
+};
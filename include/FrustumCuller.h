@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Camera.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Axis-aligned boxes stored as structure-of-arrays (centre + half extents)
+// so the culler can test several boxes per SIMD instruction.
+struct BoundsSoA
+{
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+
+    void Clear();
+    void Reserve(size_t count);
+    void Push(const glm::vec3& center, const glm::vec3& extent);
+    size_t Size() const { return centerX.size(); }
+};
+
+// FrustumCuller tests AABBs against a set of planes.
+// Batches of 8 (AVX) or 4 (SSE) boxes are tested at once; the scalar path
+// is used for the remainder and on targets without SSE.
+class FrustumCuller
+{
+public:
+    enum class Containment
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    // Classify a single box (used for coarse per-chunk tests)
+    static Containment TestAABB(const glm::vec4* planes, int planeCount,
+                                const glm::vec3& center, const glm::vec3& extent);
+
+    // Write the indices of boxes that are not fully outside into outIndices
+    // (must hold boxes.Size() entries). Returns the number written.
+    static size_t CullAABBs(const glm::vec4* planes, int planeCount,
+                            const BoundsSoA& boxes, uint32_t* outIndices);
+
+    static size_t CullAABBs(const FrustumPlanes& frustum, const BoundsSoA& boxes, uint32_t* outIndices)
+    {
+        return CullAABBs(frustum.planes, 6, boxes, outIndices);
+    }
+
+    // Name of the instruction set the batch test was compiled for
+    static const char* GetSimdPath();
+};
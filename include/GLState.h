@@ -0,0 +1,100 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// Issued vs skipped state calls (reset once per frame, shown on the HUD)
+struct GLStateStats
+{
+    uint32_t issued = 0;
+    uint32_t skipped = 0;
+};
+
+// GLState shadows the OpenGL state the renderer changes every frame (program,
+// VAO, per-unit texture bindings, framebuffers, viewport, blend/depth/cull
+// state) and drops calls that would not change anything. The wrappers mirror
+// the GL entry points they replace. Every module binds through GLState, so
+// the shadow copy stays exact; code that changes tracked state directly must
+// call Invalidate() afterwards.
+class GLState
+{
+public:
+    static constexpr int MAX_TEXTURE_UNITS = 16;
+
+    // Forget everything; the next call of each kind is always issued.
+    // Call once after the context is created (the texture table starts zeroed).
+    static void Invalidate();
+
+    static void UseProgram(GLuint program);
+    static void BindVertexArray(GLuint vao);
+
+    // unit is GL_TEXTURE0 + i, as for glActiveTexture
+    static void ActiveTexture(GLenum unit);
+    // Binds to the active unit (GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP are tracked)
+    static void BindTexture(GLenum target, GLuint texture);
+    // Sampler objects are per unit index (not GL_TEXTUREi), 0 = texture's own state
+    static void BindSampler(GLuint unit, GLuint sampler);
+
+    static void BindFramebuffer(GLenum target, GLuint framebuffer);
+    // Queries the driver only if the binding is not known yet
+    static GLuint GetDrawFramebuffer();
+    static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    static void Enable(GLenum capability);
+    static void Disable(GLenum capability);
+    static void BlendFunc(GLenum sourceFactor, GLenum destFactor);
+    static void DepthFunc(GLenum func);
+    static void DepthMask(GLboolean flag);
+    static void CullFace(GLenum mode);
+
+    // Deleting a bound object implicitly unbinds it, so the shadow copy must
+    // forget it too (otherwise a recycled name would be wrongly skipped)
+    static void DeleteTextures(GLsizei count, const GLuint* textures);
+    static void DeleteVertexArrays(GLsizei count, const GLuint* arrays);
+    static void DeleteFramebuffers(GLsizei count, const GLuint* framebuffers);
+    static void DeleteSamplers(GLsizei count, const GLuint* samplers);
+    static void DeleteProgram(GLuint program);
+
+    static const GLStateStats& GetStats() { return stats; }
+    static void ResetStats() { stats = GLStateStats(); }
+
+private:
+    enum TextureTarget { TARGET_2D, TARGET_2D_ARRAY, TARGET_CUBE_MAP, TARGET_COUNT };
+    enum Capability { CAP_DEPTH_TEST, CAP_BLEND, CAP_CULL_FACE, CAP_DEPTH_CLAMP, CAP_COUNT };
+
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    static GLuint program;
+    static GLuint vertexArray;
+    static GLuint activeUnit;
+    static GLuint textures[MAX_TEXTURE_UNITS][TARGET_COUNT];
+    static GLuint samplers[MAX_TEXTURE_UNITS];
+    static GLuint drawFramebuffer;
+    static GLuint readFramebuffer;
+    static GLint viewport[4];
+    static int capabilities[CAP_COUNT];   // -1 unknown, 0 disabled, 1 enabled
+    static GLenum blendSource;
+    static GLenum blendDest;
+    static GLenum depthFunc;
+    static int depthMask;
+    static GLenum cullFace;
+    static GLStateStats stats;
+
+    static int TargetIndex(GLenum target);
+    static int CapabilityIndex(GLenum capability);
+    static void SetCapability(GLenum capability, bool enable);
+
+    // Returns true (and counts an issued call) when the cached value changes
+    template <typename T>
+    static bool Update(T& cached, T value)
+    {
+        if (cached == value)
+        {
+            stats.skipped++;
+            return false;
+        }
+        cached = value;
+        stats.issued++;
+        return true;
+    }
+};
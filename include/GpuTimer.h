@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// GpuTimer measures GPU time of a bracketed span with GL_TIME_ELAPSED queries.
+// Queries rotate through a small ring so results are read a few frames late
+// instead of stalling the CPU on the current frame. Only one timer may be
+// active at a time (GL does not nest TIME_ELAPSED queries).
+class GpuTimer
+{
+public:
+    static constexpr int QUERY_COUNT = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+
+    void Initialize();
+    void Cleanup();
+
+    void Begin();
+    void End();
+
+    // Most recent completed measurement
+    double GetLastMs() const { return lastMs; }
+
+    // Mean over all measurements since the last ResetAverage(); results still
+    // in flight at reset time measured the old configuration and are dropped
+    double GetAverageMs() const { return sampleCount > 0 ? totalMs / sampleCount : 0.0; }
+    uint32_t GetSampleCount() const { return sampleCount; }
+    void ResetAverage();
+
+private:
+    unsigned int queries[QUERY_COUNT];
+    bool pending[QUERY_COUNT];
+    bool discard[QUERY_COUNT];
+    int current;
+    bool initialized;
+
+    double lastMs;
+    double totalMs;
+    uint32_t sampleCount;
+
+    void Collect(int index);
+};
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "Shader.h"
 
 // Simple bitmap font for HUD overlay
 // 8x8 font with ASCII characters 32-127
@@ -19,11 +20,11 @@ public:
 private:
     unsigned int fontTexture;
     unsigned int textVAO, textVBO;
-    unsigned int textShader;
+    Shader textShader;
     
     void CreateFontTexture();
     void SetupRenderData();
-    unsigned int CompileTextShader();
+    bool CompileTextShader();
 };
 
 // Simple 8x8 bitmap font data (96 characters: space to ~)
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "Texture.h"
+#include "Shader.h"
 
 struct Vertex
 {
@@ -24,7 +25,7 @@ public:
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
 
     // Render the mesh
-    void Draw(unsigned int shaderProgram);
+    void Draw(const Shader& shader);
 
     // Cleanup
     void Delete();
@@ -33,6 +34,9 @@ private:
     // Render data
     unsigned int VAO, VBO, EBO;
 
+    // Sampler uniform per texture ("material.diffuse1", ...), hashed once
+    std::vector<UniformId> textureUniforms;
+
     // Setup mesh
     void setupMesh();
 };
@@ -20,7 +20,7 @@ public:
     Model(const std::string& path, const std::string& fallbackTexturePath = "");
 
     // Draw the model
-    void Draw(unsigned int shaderProgram);
+    void Draw(const Shader& shader);
 
     // Cleanup
     void Delete();
@@ -1,8 +1,24 @@
 #pragma once
 #include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "GpuTimer.h"
+#include "FrameGraph.h"
+#include "AutoExposure.h"
+
+// Bloom blur path: the original ping-pong Gaussian (kept for comparison) or a
+// progressive downsample/upsample over a mip chain of the bright buffer
+enum BloomMode {
+    BLOOM_GAUSSIAN,
+    BLOOM_DUAL_FILTER
+};
 
 class PostProcessor {
 public:
+    static constexpr int MAX_BLOOM_LEVELS = 8;
+    static constexpr int MAX_BLUR_RADIUS = 32;
+    static constexpr int MAX_BLUR_TAPS = MAX_BLUR_RADIUS / 2 + 1;  // Linear-sampled taps (blur.frag)
+
     PostProcessor(unsigned int width, unsigned int height);
     ~PostProcessor();
 
@@ -13,46 +29,161 @@ public:
     void Render(float exposure, bool enableBloom, bool enableGamma, float bloomStrength, int debugMode);
     void Cleanup();
 
-    // Resize framebuffers
+    // Resize the output; only the HDR target is reallocated (shaders stay loaded)
     void Resize(unsigned int width, unsigned int height);
 
+    // The scene and bloom render at this fraction of the output size; the final
+    // pass upscales to the full output with bilinear filtering (0.25 to 1)
+    void SetRenderScale(float scale);
+    float GetRenderScale() const { return renderScale; }
+    // Size of the HDR scene target (the viewport the scene pass must use)
+    unsigned int GetRenderWidth() const { return renderWidth; }
+    unsigned int GetRenderHeight() const { return renderHeight; }
+
     // Check if initialized
     bool IsInitialized() const { return initialized; }
 
+    // One separable Gaussian pass (RGBA): horizontal from sourceTexture into
+    // the scratch target, then vertical into destFBO. Shared by bloom and the
+    // shadow-moment prefilter; leaves destFBO bound.
+    void SeparableBlur(unsigned int sourceTexture, unsigned int scratchFBO, unsigned int scratchTexture,
+                       unsigned int destFBO, unsigned int blurWidth, unsigned int blurHeight);
+
+    // Kernel radius in texels per direction (1 to MAX_BLUR_RADIUS; 4 = the original 9-tap blur).
+    // Weights are generated on the CPU and paired into bilinear taps
+    void SetBlurRadius(int radius);
+    int GetBlurRadius() const { return blurRadius; }
+    // Texture fetches per pixel per direction for the current radius
+    int GetBlurFetchCount() const { return 2 * blurTapCount - 1; }
+
+    // Fullscreen quad (postprocess.vert layout) for other fullscreen passes
+    void RenderScreenQuad();
+
+    // Luminance above which HDR pixels feed the bloom (applied when bloom reads the scene)
+    void SetBloomThreshold(float threshold) { bloomThreshold = threshold; }
+    float GetBloomThreshold() const { return bloomThreshold; }
+
     // Public getters for debug visualization
     unsigned int GetHDRTexture() const { return hdrColorBuffer; }
-    unsigned int GetBrightTexture() const { return brightColorBuffer; }
-    unsigned int GetBloomTexture() const { return bloomColorBuffers[0]; }
+
+    // Switching modes logs the GPU time of the previous one (average since the last switch)
+    void SetBloomMode(BloomMode mode);
+    BloomMode GetBloomMode() const { return bloomMode; }
+    const char* GetBloomModeName() const { return bloomMode == BLOOM_DUAL_FILTER ? "Dual filter" : "Gaussian"; }
+    // Mip levels of the dual-filter chain (1 to MAX_BLOOM_LEVELS; more = wider bloom)
+    void SetBloomLevels(int levels);
+    int GetBloomLevels() const { return bloomLevels; }
+    // GPU time of the last measured bloom pass
+    double GetBloomGpuMs() const { return bloomTimer.GetLastMs(); }
+
+    // Automatic exposure: the exposure passed to Render() becomes a
+    // compensation factor on top of the adapted value
+    void SetAutoExposure(bool enable) { autoExposureEnabled = enable; }
+    bool IsAutoExposureEnabled() const { return autoExposureEnabled; }
+    // Collects finished luminance readbacks and adapts; call once per frame
+    void UpdateExposure(float deltaTime);
+    const AutoExposure& GetAutoExposure() const { return autoExposure; }
+
+    // Temporal upsampling: the scene renders with a jittered projection at
+    // the render scale; a velocity pass reprojects each pixel with last
+    // frame's view-projection and the resolve accumulates it into an
+    // output-resolution history, clamped to the current neighbourhood
+    void SetTemporalUpsampling(bool enable);
+    bool IsTemporalUpsamplingEnabled() const { return temporalUpsampling; }
+    // Unjittered view-projection and the jitter (NDC) of the frame being rendered; call once per frame
+    void SetCameraMatrices(const glm::mat4& viewProjection, const glm::vec2& jitter);
+    // GPU time of the velocity and resolve passes
+    double GetTemporalGpuMs() const { return temporalTimer.GetLastMs(); }
+
+    // SSAO from the depth already in the HDR target (a depth prepass), at half
+    // render resolution: occlusion pass plus a depth-aware separable blur.
+    // Call between the prepass and the lit pass; leaves the HDR target bound.
+    // The scene shaders upsample the result bilaterally (r = visibility,
+    // g = linear view depth)
+    void ComputeAmbientOcclusion(const glm::mat4& projection);
+    bool IsAmbientOcclusionAvailable() const { return ssaoShader.IsValid() && ssaoBlurShader.IsValid(); }
+    unsigned int GetAmbientOcclusionTexture() const { return occlusionTexture; }
+    // GPU time of the occlusion and blur passes
+    double GetAmbientOcclusionGpuMs() const { return occlusionTimer.GetLastMs(); }
+
+    // Passes, culling and pooled-target memory of the last rendered frame
+    const FrameGraph::Stats& GetFrameGraphStats() const { return frameGraph.GetStats(); }
 
 private:
-    unsigned int width, height;
+    unsigned int width, height;  // Output (window) size
+    float renderScale;
+    unsigned int renderWidth, renderHeight;
     bool initialized;
 
-    // HDR framebuffer
+    // HDR framebuffer (single color target; bloom extracts its bright pass from it)
     unsigned int hdrFBO;
     unsigned int hdrColorBuffer;
-    unsigned int hdrDepthBuffer;
+    unsigned int hdrDepthBuffer;  // Depth texture (read by the velocity pass)
 
-    // Bloom framebuffers (ping-pong)
-    unsigned int bloomFBO[2];
-    unsigned int bloomColorBuffers[2];
+    // Temporal history at output resolution (ping-pong: read one, write the other)
+    unsigned int historyFBO[2];
+    unsigned int historyTextures[2];
+    int historyIndex;     // Texture holding the previous resolve
+    bool historyValid;
+    bool temporalUpsampling;
+    glm::mat4 viewProjection;
+    glm::mat4 prevViewProjection;
+    glm::vec2 jitter;
+    GpuTimer temporalTimer;
 
-    // Bright pass framebuffer
-    unsigned int brightFBO;
-    unsigned int brightColorBuffer;
+    // Blurred SSAO at half render resolution (read by the lit pass, so not pooled);
+    // built by its own graph because it runs mid-frame, before the scene is lit
+    unsigned int occlusionFBO;
+    unsigned int occlusionTexture;
+    FrameGraph occlusionGraph;
+    GpuTimer occlusionTimer;
+
+    // Bright pass, blur and bloom-chain targets are declared per frame and
+    // allocated from the graph's pool (dual-filter level 0 is half resolution,
+    // each level halves again)
+    FrameGraph frameGraph;
+    float bloomThreshold;
+    int bloomLevels;
+    BloomMode bloomMode;
+    GpuTimer bloomTimer;
+    int bloomLastPass;  // Pass that closes the bloom timer
+    bool bloomTimed;    // That pass survived culling this frame
+
+    // Average scene luminance, read back asynchronously
+    AutoExposure autoExposure;
+    bool autoExposureEnabled;
+
+    // Separable blur kernel (linear-sampled: tap 0 is the centre, the rest are mirrored)
+    int blurRadius;
+    int blurTapCount;
+    float blurWeights[MAX_BLUR_TAPS];
+    float blurOffsets[MAX_BLUR_TAPS];
 
     // Screen quad VAO/VBO
     unsigned int quadVAO, quadVBO;
 
     // Shaders
-    unsigned int postprocessShader;
-    unsigned int bloomExtractShader;
-    unsigned int blurShader;
+    Shader postprocessShader;
+    Shader bloomExtractShader;
+    Shader blurShader;
+    Shader bloomDownsampleShader;
+    Shader bloomUpsampleShader;
+    Shader luminanceShader;
+    Shader velocityShader;
+    Shader taaResolveShader;
+    Shader ssaoShader;
+    Shader ssaoBlurShader;
 
     void CreateFramebuffers();
+    void ReleaseFramebuffers();
     void CreateScreenQuad();
     void LoadShaders();
-    void RenderScreenQuad();
-    void ApplyBloom();
+    void BlurDirection(unsigned int sourceTexture, bool horizontal);
+    RenderTargetDesc HalfResolutionDesc() const;
+    FrameGraph::ResourceId AddBrightPass(FrameGraph::ResourceId hdr);
+    FrameGraph::ResourceId AddGaussianBloom(FrameGraph::ResourceId bright);
+    FrameGraph::ResourceId AddDualFilterBloom(FrameGraph::ResourceId hdr);
+    void AddLuminancePass(FrameGraph::ResourceId hdr);
+    FrameGraph::ResourceId AddTemporalResolve(FrameGraph::ResourceId hdr);
     bool CheckFramebufferStatus(unsigned int fbo, const char* name);
 };
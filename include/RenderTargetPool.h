@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+// Size and format of a single-attachment color target
+struct RenderTargetDesc
+{
+    unsigned int width;
+    unsigned int height;
+    GLenum internalFormat;
+
+    bool operator==(const RenderTargetDesc& other) const
+    {
+        return width == other.width && height == other.height && internalFormat == other.internalFormat;
+    }
+};
+
+// A pooled texture with its framebuffer (linear filtering, clamped to edge)
+struct RenderTarget
+{
+    RenderTargetDesc desc;
+    unsigned int texture;
+    unsigned int fbo;
+    bool acquired;      // Currently handed out
+    bool usedThisFrame;
+    int idleFrames;     // Consecutive frames nobody acquired it
+};
+
+// RenderTargetPool recycles color targets between passes and frames. A target
+// is acquired for the span of passes that use it and released afterwards, so
+// a later acquire with the same desc gets the same texture (aliasing). Targets
+// left idle for RELEASE_AFTER_FRAMES frames are deleted, which is how old
+// sizes disappear after a resize or a mode switch.
+class RenderTargetPool
+{
+public:
+    static constexpr int RELEASE_AFTER_FRAMES = 30;
+
+    RenderTargetPool();
+    ~RenderTargetPool();
+
+    // Index of a free target matching desc (allocated if none is free); valid until EndFrame()
+    int Acquire(const RenderTargetDesc& desc);
+    void Release(int index);
+    const RenderTarget& Get(int index) const { return targets[index]; }
+
+    // Ages idle targets, deletes stale ones and frees every acquisition
+    void EndFrame();
+    void Clear();
+
+    size_t GetTargetCount() const { return targets.size(); }
+    size_t GetAllocatedBytes() const;
+
+    static size_t BytesPerPixel(GLenum internalFormat);
+
+private:
+    std::vector<RenderTarget> targets;
+
+    void Delete(RenderTarget& target);
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Hashed uniform name. Built implicitly from a string literal, so call sites
+// read shader.SetMat4("view", m); the lookup is a hash-table probe, never a
+// glGetUniformLocation call. Used that way the FNV-1a hash is a cheap runtime
+// loop that optimised builds usually fold; it is only guaranteed to run at
+// compile time when the id is a constexpr constant, as the per-frame call
+// sites declare theirs (constexpr UniformId EXPOSURE("exposure")).
+struct UniformId
+{
+    uint32_t hash;
+
+    constexpr UniformId(const char* name) : hash(Hash(name)) {}
+    constexpr explicit UniformId(uint32_t nameHash) : hash(nameHash) {}
+
+    static constexpr uint32_t Hash(const char* name)
+    {
+        uint32_t h = 2166136261u;
+        while (*name)
+        {
+            h = (h ^ static_cast<uint8_t>(*name++)) * 16777619u;
+        }
+        return h;
+    }
+};
+
+// Shader owns a linked GL program. After linking, every active uniform is
+// reflected once with glGetActiveUniform into a hash -> location table.
+// Setters write to the currently bound program, so call Use() first.
+class Shader
+{
+public:
+    Shader();
+    ~Shader();
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+    Shader(Shader&& other) noexcept;
+    Shader& operator=(Shader&& other) noexcept;
+
+    // Compile and link; returns false (and logs the GL info log) on failure
+    bool LoadFromFiles(const char* vertexPath, const char* fragmentPath);
+    bool LoadFromSource(const char* vertexSource, const char* fragmentSource, const std::string& label);
+
+    void Use() const;
+    void Delete();
+
+    unsigned int GetID() const { return ID; }
+    bool IsValid() const { return ID != 0; }
+    const std::string& GetLabel() const { return label; }
+
+    // -1 when the uniform is not active (optimized out or misspelled)
+    int GetLocation(UniformId id) const;
+    bool HasUniform(UniformId id) const { return GetLocation(id) != -1; }
+    size_t GetUniformCount() const { return uniformLocations.size(); }
+
+    // Typed setters (no-ops for inactive uniforms, like glUniform* with -1)
+    void SetBool(UniformId id, bool value) const;
+    void SetInt(UniformId id, int value) const;
+    void SetFloat(UniformId id, float value) const;
+    void SetVec2(UniformId id, const glm::vec2& value) const;
+    void SetVec3(UniformId id, const glm::vec3& value) const;
+    void SetVec4(UniformId id, const glm::vec4& value) const;
+    void SetMat3(UniformId id, const glm::mat3& value) const;
+    void SetMat4(UniformId id, const glm::mat4& value) const;
+    // Uploads `count` elements starting at the array's first element (pass the bare array name)
+    void SetFloatArray(UniformId id, const float* values, int count) const;
+
+    static std::string LoadSourceFile(const char* path);
+
+    // Any program linked afterwards that declares uniform block `blockName`
+    // gets it attached to `binding` (GLSL 330 has no layout(binding = N))
+    static void SetUniformBlockBinding(const std::string& blockName, unsigned int binding);
+
+private:
+    unsigned int ID;
+    std::string label;
+    std::unordered_map<uint32_t, int> uniformLocations;
+
+    static unsigned int CompileStage(GLenum type, const char* source, const std::string& label);
+    void ReflectUniforms();
+    void BindUniformBlocks() const;
+
+    static std::unordered_map<std::string, unsigned int> uniformBlockBindings;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// ShaderCache stores linked program binaries (glGetProgramBinary) on disk so
+// later runs skip GLSL compilation. Entries are keyed by a hash of the shader
+// sources plus GL_VENDOR/GL_RENDERER/GL_VERSION, so a driver update or an
+// edited shader simply misses and recompiles. Requires GL 4.1 program
+// binaries at runtime; otherwise every call is a no-op miss.
+class ShaderCache
+{
+public:
+    // Call once after the GL loader is initialized
+    static void Initialize(const std::string& directory = "shader_cache", bool enable = true);
+    static bool IsEnabled() { return enabled; }
+
+    static uint64_t ComputeKey(const char* vertexSource, const char* fragmentSource);
+
+    // Returns a linked program, or 0 on miss / stale / rejected binary
+    static unsigned int Load(uint64_t key);
+    static void Store(uint64_t key, unsigned int program);
+
+    // Startup timing bookkeeping (Shader records every program it creates)
+    static void RecordProgram(bool fromCache, double milliseconds);
+    static void LogStartupStats();
+
+private:
+    static bool enabled;
+    static std::string cacheDirectory;
+    static std::string driverSignature;
+
+    static int cachedPrograms;
+    static int compiledPrograms;
+    static double cachedMs;
+    static double compiledMs;
+
+    static std::string PathForKey(uint64_t key);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Shader.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ShaderVariants builds compile-time permutations of one vertex/fragment pair.
+// Feature bit i maps to featureDefines[i]; the enabled ones are injected as
+// #define lines right after #version, so disabled code paths are removed by
+// the preprocessor instead of being skipped by uniform branches at runtime.
+// Variants are compiled on first request and kept until Clear().
+class ShaderVariants
+{
+public:
+    // Runs once on every newly linked variant (constant samplers etc.)
+    using SetupFn = std::function<void(const Shader&)>;
+
+    ShaderVariants();
+
+    // An empty define marks a bit this pair ignores; such bits are masked out
+    // so they never produce duplicate programs
+    bool Load(const char* vertexPath, const char* fragmentPath,
+              const std::vector<std::string>& featureDefines, SetupFn setup = nullptr);
+
+    // Program for the requested feature bits, compiled lazily. A variant that
+    // fails to compile is remembered (invalid Shader) and not retried.
+    const Shader& Get(uint32_t features);
+
+    size_t GetCompiledCount() const { return variants.size(); }
+    void Clear();
+
+    // Insert "#define NAME" lines after the #version directive, followed by
+    // a #line so compiler errors still point at the original file lines
+    static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+private:
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::string vertexSource;
+    std::string fragmentSource;
+    std::vector<std::string> featureDefines;
+    uint32_t supportedFeatures;
+    SetupFn setup;
+
+    std::unordered_map<uint32_t, Shader> variants;
+};
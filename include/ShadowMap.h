@@ -1,37 +1,164 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 #include <iostream>
+#include <algorithm>
+#include "Shader.h"
 
+class Camera;
+class PostProcessor;
+
+// Cascaded shadow map for the directional light. The camera frustum (up to
+// the shadow distance) is split with the practical split scheme and each
+// slice gets its own orthographic projection, rendered into one layer of a
+// GL_TEXTURE_2D_ARRAY depth texture. The projection covers the slice clipped
+// to the scene bounds, has a fixed size per split and a texel-snapped origin
+// (no shimmering), and takes its depth range from the caster bounds.
+//
+// Static casters (ground, city) are cached in a second array. A cascade keeps
+// its light projection, padded a little, for as long as its slice still fits
+// inside it, and its static layer is re-rendered only when that projection,
+// the light direction or the static scene changes. Each frame the cached
+// depth is copied into the sampled array and dynamic casters are drawn on top
+// with the depth test, giving min(static, dynamic).
+//
+// Cascades can also be refreshed on an amortised schedule: a cascade with an
+// update interval of N is refit and re-rendered every Nth frame (staggered so
+// cascades share the load) and keeps its previous matrix and depth meanwhile.
+//
+// For EVSM the depth layers are converted into warped moments (RGBA32F),
+// blurred once with PostProcessor's separable blur and mipmapped, so the
+// scene shaders need a single filtered fetch instead of a PCF kernel.
 class ShadowMap
 {
 public:
-    // Constructor
-    ShadowMap(unsigned int width = 2048, unsigned int height = 2048);
-    
+    static constexpr int MIN_CASCADES = 2;
+    static constexpr int MAX_CASCADES = 4;
+
+    // Constructor (resolution is per cascade layer; count is clamped to 2-4)
+    ShadowMap(unsigned int resolution = 1024, int cascadeCount = 3);
+
     // Destructor
     ~ShadowMap();
 
-    // Bind for writing (depth pass)
-    void BindForWriting();
-    
-    // Bind for reading (main pass)
-    void BindForReading(GLenum textureUnit);
-    
+    // Delete every GL object; call before the context is destroyed
+    void Cleanup();
+
+    // Reallocate every layer (and the EVSM moment textures, not the program) at a
+    // new per-cascade resolution; all cascades are refit and re-rendered on the next Update()
+    void SetResolution(unsigned int resolution);
+
+    // Recompute split distances and per-cascade light matrices for this frame
+    // (a cascade keeps its cached matrix while the slice fits inside it)
+    void Update(const Camera& camera, float aspectRatio, const glm::vec3& lightDirection);
+
+    // Amortised refresh: the cascade is refit and rendered every `frames` frames (1 = always)
+    void SetUpdateInterval(int cascade, int frames) { m_UpdateIntervals[cascade] = std::max(frames, 1); }
+    int GetUpdateInterval(int cascade) const { return m_UpdateIntervals[cascade]; }
+    // Whether the cascade was scheduled by this frame's Update(); skip its rendering otherwise
+    bool IsCascadeDue(int cascade) const { return m_CascadeDue[cascade]; }
+
+    // World AABB of everything that casts or receives shadows; clips the
+    // cascade footprints and sets the near plane (changes invalidate the cache)
+    void SetSceneBounds(const glm::vec3& minBounds, const glm::vec3& maxBounds);
+
+    // Static casters changed: every static layer is re-rendered on next use
+    void InvalidateStatic();
+    bool IsStaticValid(int cascade) const { return m_StaticValid[cascade]; }
+
+    // Bind one static cache layer for writing (cleared, then marked valid)
+    void BindStaticForWriting(int cascade);
+
+    // Bind one cascade layer for writing dynamic casters: the layer starts as
+    // a copy of its static cache, so only dynamic casters need drawing
+    void BindForWriting(int cascade);
+
+    // Bind the whole cascade array for reading (main pass). The texture is set
+    // up for depth-compare lookups (sampler2DArrayShadow, hardware PCF);
+    // rawDepth binds a plain sampler object instead, for sampler2DArray reads
+    void BindForReading(GLenum textureUnit, bool rawDepth = false);
+
     // Unbind (restore previous framebuffer)
     void Unbind();
 
+    // EVSM: convert, prefilter and mipmap the cascades rendered this frame (and
+    // any whose moments are stale). Call after the depth pass, before Unbind().
+    // Resources are created on first use; returns false if that failed.
+    bool UpdateMoments(PostProcessor& blur);
+    // Moments go stale while EVSM is off; the next UpdateMoments redoes every cascade
+    void InvalidateMoments();
+    // Bind the moment array (sampler2DArray) for the SHADOWS_EVSM variants
+    void BindMomentsForReading(GLenum textureUnit);
+
+    // Split tuning: lambda blends logarithmic (1) and uniform (0) splits
+    // (both change the slices, so cached static layers are dropped)
+    void SetSplitLambda(float lambda) { m_SplitLambda = lambda; InvalidateStatic(); }
+    void SetShadowDistance(float distance) { m_ShadowDistance = distance; InvalidateStatic(); }
+    // Fraction of the slice extent added on each side when a cascade is refit;
+    // larger values refit less often but spend more texels outside the slice
+    void SetCachePadding(float padding) { m_CachePadding = padding; }
+
     // Getters
-    unsigned int GetWidth() const { return m_Width; }
-    unsigned int GetHeight() const { return m_Height; }
+    unsigned int GetWidth() const { return m_Resolution; }
+    unsigned int GetHeight() const { return m_Resolution; }
     unsigned int GetDepthTexture() const { return m_DepthTexture; }
-    
+    int GetCascadeCount() const { return m_CascadeCount; }
+    const glm::mat4& GetLightSpaceMatrix(int cascade) const { return m_LightSpaceMatrices[cascade]; }
+    // View-space distance where the cascade ends
+    float GetSplitDistance(int cascade) const { return m_SplitDistances[cascade]; }
+
 private:
     unsigned int m_FBO;
     unsigned int m_DepthTexture;
-    unsigned int m_Width;
-    unsigned int m_Height;
+    unsigned int m_StaticFBO;
+    unsigned int m_StaticTexture;  // Static casters only, copied into m_DepthTexture each frame
+    unsigned int m_RawSampler;  // Compare mode off, nearest filtering
+    unsigned int m_Resolution;
+    int m_CascadeCount;
     GLint m_PreviousFBO;  // Store previous FBO to restore after shadow pass
-    
+
+    float m_SplitLambda;
+    float m_ShadowDistance;
+    float m_CasterMargin;  // Extra depth toward the light for casters outside a slice
+    float m_CachePadding;
+    float m_SplitDistances[MAX_CASCADES];
+    glm::mat4 m_LightSpaceMatrices[MAX_CASCADES];
+
+    // Light-view rotation and the cached (padded) light-space box per cascade.
+    // Each cascade remembers the direction it was fitted for, since amortised
+    // cascades may still hold an older one
+    glm::vec3 m_LightDirection;
+    glm::mat4 m_LightView;
+    glm::vec3 m_CascadeLightDirections[MAX_CASCADES];
+    glm::vec3 m_BoundsMin[MAX_CASCADES];
+    glm::vec3 m_BoundsMax[MAX_CASCADES];
+    glm::vec2 m_TexelSizes[MAX_CASCADES];  // World units per texel of each box
+    bool m_StaticValid[MAX_CASCADES];
+
+    // Amortised refresh schedule
+    int m_UpdateIntervals[MAX_CASCADES];
+    bool m_CascadeDue[MAX_CASCADES];
+    bool m_CascadeFitted[MAX_CASCADES];  // Rendered at least once (always due until then)
+    unsigned int m_FrameIndex;
+
+    bool m_HasSceneBounds;
+    glm::vec3 m_SceneMin;
+    glm::vec3 m_SceneMax;
+
+    // EVSM moments (allocated on first UpdateMoments)
+    unsigned int m_MomentTexture;         // RGBA32F array with mips, one layer per cascade
+    unsigned int m_MomentFBO;             // Attached to one layer at a time
+    unsigned int m_MomentScratchTexture;  // Unfiltered moments of one cascade
+    unsigned int m_MomentScratchFBO;
+    unsigned int m_MomentBlurTexture;     // Horizontal blur result
+    unsigned int m_MomentBlurFBO;
+    Shader m_MomentShader;
+    bool m_MomentsInitialized;            // Program load attempted (kept across resizes)
+    bool m_MomentValid[MAX_CASCADES];
+
     void Init();
+    void Release();
+    bool InitMoments();
+    void SliceBounds(const glm::mat4& inverseViewProjection, glm::vec3& minBounds, glm::vec3& maxBounds, float& radius) const;
 };
@@ -0,0 +1,84 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D source;
+uniform bool prefilter;      // First downsample only: reads the HDR scene, applies the threshold and Karis average
+uniform float threshold;     // Bright-pass luminance threshold (prefilter only)
+
+// 13-tap downsample (Jimenez, "Next Generation Post Processing in Call of Duty").
+// Five overlapping 2x2 boxes, weighted so the result is a smooth 4x4-texel filter:
+//   a - b - c
+//   - j - k -
+//   d - e - f
+//   - l - m -
+//   g - h - i
+
+float Luma(vec3 c)
+{
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Bright-pass extraction: only pixels above the threshold feed the bloom
+vec3 Tap(vec2 uv)
+{
+    vec3 c = texture(source, uv).rgb;
+    if (prefilter && Luma(c) <= threshold) {
+        return vec3(0.0);
+    }
+    return c;
+}
+
+// Average of one 2x2 box, with its Karis weight 1 / (1 + luma) in .a,
+// so one very bright texel cannot dominate the filtered result
+vec4 KarisBox(vec3 p0, vec3 p1, vec3 p2, vec3 p3)
+{
+    vec3 avg = (p0 + p1 + p2 + p3) * 0.25;
+    return vec4(avg, 1.0 / (1.0 + Luma(avg)));
+}
+
+void main()
+{
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    float x = texel.x;
+    float y = texel.y;
+    
+    vec3 a = Tap(TexCoords + vec2(-2.0 * x,  2.0 * y));
+    vec3 b = Tap(TexCoords + vec2( 0.0,      2.0 * y));
+    vec3 c = Tap(TexCoords + vec2( 2.0 * x,  2.0 * y));
+    vec3 d = Tap(TexCoords + vec2(-2.0 * x,  0.0));
+    vec3 e = Tap(TexCoords);
+    vec3 f = Tap(TexCoords + vec2( 2.0 * x,  0.0));
+    vec3 g = Tap(TexCoords + vec2(-2.0 * x, -2.0 * y));
+    vec3 h = Tap(TexCoords + vec2( 0.0,     -2.0 * y));
+    vec3 i = Tap(TexCoords + vec2( 2.0 * x, -2.0 * y));
+    vec3 j = Tap(TexCoords + vec2(-x,  y));
+    vec3 k = Tap(TexCoords + vec2( x,  y));
+    vec3 l = Tap(TexCoords + vec2(-x, -y));
+    vec3 m = Tap(TexCoords + vec2( x, -y));
+    
+    vec3 result;
+    if (prefilter) {
+        // Each box keeps its 13-tap share (0.5 center, 0.125 corners) scaled by its
+        // Karis weight; dividing by the weight sum renormalises the filter
+        vec4 boxes[5] = vec4[5](KarisBox(j, k, l, m), KarisBox(a, b, d, e), KarisBox(b, c, e, f),
+                                KarisBox(d, e, g, h), KarisBox(e, f, h, i));
+        float shares[5] = float[5](0.5, 0.125, 0.125, 0.125, 0.125);
+        vec3 sum = vec3(0.0);
+        float weightSum = 0.0;
+        for (int n = 0; n < 5; ++n) {
+            float w = shares[n] * boxes[n].a;
+            sum += boxes[n].rgb * w;
+            weightSum += w;
+        }
+        result = sum / weightSum;
+    } else {
+        result = (j + k + l + m) * 0.125
+               + (a + c + g + i) * 0.03125
+               + (b + d + f + h) * 0.0625
+               + e * 0.125;
+    }
+    
+    FragColor = vec4(max(result, vec3(0.0001)), 1.0);
+}
@@ -0,0 +1,28 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// Next smaller mip; the result is added onto the larger one with GL_ONE, GL_ONE blending
+uniform sampler2D source;
+uniform float filterRadius;   // In source texels
+
+// 3x3 tent filter (weights 1-2-1 / 2-4-2 / 1-2-1, divided by 16)
+void main()
+{
+    vec2 offset = filterRadius / vec2(textureSize(source, 0));
+    float x = offset.x;
+    float y = offset.y;
+    
+    vec3 result = texture(source, TexCoords).rgb * 4.0;
+    result += (texture(source, TexCoords + vec2(-x, 0.0)).rgb +
+               texture(source, TexCoords + vec2( x, 0.0)).rgb +
+               texture(source, TexCoords + vec2(0.0, -y)).rgb +
+               texture(source, TexCoords + vec2(0.0,  y)).rgb) * 2.0;
+    result += texture(source, TexCoords + vec2(-x, -y)).rgb +
+              texture(source, TexCoords + vec2( x, -y)).rgb +
+              texture(source, TexCoords + vec2(-x,  y)).rgb +
+              texture(source, TexCoords + vec2( x,  y)).rgb;
+    
+    FragColor = vec4(result / 16.0, 1.0);
+}
@@ -7,32 +7,27 @@ in vec2 TexCoords;
 uniform sampler2D image;
 uniform bool horizontal;
 
-// Gaussian blur weights (9-tap kernel for smooth bloom)
-const float weight[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+// Gaussian kernel generated by PostProcessor::SetBlurRadius. Tap 0 is the
+// centre texel; every other tap sits between two texels at the offset where
+// one bilinear fetch returns their weighted sum, so a radius-r kernel costs
+// 1 + 2 * ceil(r / 2) fetches instead of 2r + 1.
+const int MAX_BLUR_TAPS = 17;   // PostProcessor::MAX_BLUR_TAPS
+uniform int tapCount;
+uniform float weights[MAX_BLUR_TAPS];
+uniform float offsets[MAX_BLUR_TAPS];   // In texels
 
 void main()
 {
     vec2 tex_offset = 1.0 / textureSize(image, 0); // Size of single texel
-    vec3 result = texture(image, TexCoords).rgb * weight[0]; // Current fragment
+    vec2 direction = horizontal ? vec2(tex_offset.x, 0.0) : vec2(0.0, tex_offset.y);
     
-    if (horizontal)
+    // All four channels are filtered (shadow moments use alpha; bloom ignores it)
+    vec4 result = texture(image, TexCoords) * weights[0]; // Current fragment
+    for (int i = 1; i < tapCount; ++i)
     {
-        // Horizontal blur
-        for (int i = 1; i < 5; ++i)
-        {
-            result += texture(image, TexCoords + vec2(tex_offset.x * i, 0.0)).rgb * weight[i];
-            result += texture(image, TexCoords - vec2(tex_offset.x * i, 0.0)).rgb * weight[i];
-        }
-    }
-    else
-    {
-        // Vertical blur
-        for (int i = 1; i < 5; ++i)
-        {
-            result += texture(image, TexCoords + vec2(0.0, tex_offset.y * i)).rgb * weight[i];
-            result += texture(image, TexCoords - vec2(0.0, tex_offset.y * i)).rgb * weight[i];
-        }
+        result += texture(image, TexCoords + direction * offsets[i]) * weights[i];
+        result += texture(image, TexCoords - direction * offsets[i]) * weights[i];
     }
     
-    FragColor = vec4(result, 1.0);
+    FragColor = result;
 }
@@ -1,118 +1,274 @@
 #version 330 core
 
-// MRT outputs for HDR + Bloom (matching model.frag)
+// Compile-time permutations: SHADOWS, SHADOWS_PCF, PCF_*, SHADOWS_EVSM,
+// AMBIENT_OCCLUSION (see model.frag)
+
+// Single HDR target (matching model.frag)
 layout(location = 0) out vec4 FragColor;
-layout(location = 1) out vec4 BrightColor;
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
-in vec4 FragPosLightSpace;
+flat in float TextureLayer;
+
+// Facade texture array (one layer per facade, layer chosen per instance)
+uniform sampler2DArray buildingTextures;
+
+// Per-frame data shared by all scene programs (FrameUniforms, binding 0)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrices[4];   // One per shadow cascade
+    vec4 viewPos;                 // xyz
+    vec4 dirLightDir;             // xyz
+    vec4 dirLightColor;           // xyz
+    vec4 pointLightPos;           // xyz
+    vec4 pointLightColor;         // xyz
+    vec4 pointLightAttenuation;   // constant, linear, quadratic
+    vec4 cascadeSplits;           // View-space far distance of each cascade
+    int cascadeCount;
+};
+
+#ifdef SHADOWS
+// Cascaded shadow map: one layer per cascade
+#if defined(SHADOWS_EVSM)
+// Prefiltered EVSM moments (ShadowMap binds its moment array for this variant)
+uniform sampler2DArray shadowMap;
+#elif defined(PCF_LEGACY_LOOP)
+// Raw depth (ShadowMap binds its non-comparing sampler for this variant)
+uniform sampler2DArray shadowMap;
+#else
+// Depth-compare sampler: every fetch is a hardware-filtered 2x2 PCF
+uniform sampler2DArrayShadow shadowMap;
+#endif
+
+// Taps per side of the PCF kernel (1, 4, 9 or 16 bilinear taps)
+#if defined(PCF_TAPS_16)
+const int PCF_GRID = 4;
+#elif defined(PCF_TAPS_9)
+const int PCF_GRID = 3;
+#elif defined(PCF_TAPS_4)
+const int PCF_GRID = 2;
+#else
+const int PCF_GRID = 1;
+#endif
 
-// Texture
-uniform sampler2D buildingTexture;
+// Kernel spread in texels per tap step (buildings used a 1-texel 7x7 footprint)
+const float PCF_SPREAD = 1.0;
 
-// Lights
-uniform vec3 dirLightDir;
-uniform vec3 dirLightColor;
-uniform vec3 pointLightPos;
-uniform vec3 pointLightColor;
-uniform float pointLightConstant;
-uniform float pointLightLinear;
-uniform float pointLightQuadratic;
+#ifdef PCF_POISSON
+const vec2 POISSON_DISK[16] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379),
+    vec2( 0.44323325, -0.97511554), vec2( 0.53742981, -0.47373420),
+    vec2(-0.26496911, -0.41893023), vec2( 0.79197514,  0.19090188),
+    vec2(-0.24188840,  0.99706507), vec2(-0.81409955,  0.91437590),
+    vec2( 0.19984126,  0.78641367), vec2( 0.14383161, -0.14100790)
+);
+
+// Per-pixel rotation of the disk (interleaved gradient noise) turns banding into fine noise
+float InterleavedGradientNoise(vec2 pixel)
+{
+    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));
+}
+#endif
+
+// First cascade whose far split lies beyond this view depth (-1 past the last)
+int SelectCascade(float viewDepth)
+{
+    for (int i = 0; i < cascadeCount; ++i) {
+        if (viewDepth < cascadeSplits[i])
+            return i;
+    }
+    return -1;
+}
 
-// Camera
-uniform vec3 viewPos;
+// Light-space position in [0,1] (perspective divide is a no-op for the ortho light)
+vec3 ProjectToCascade(vec3 fragPos, int cascade)
+{
+    vec4 fragPosLightSpace = lightSpaceMatrices[cascade] * vec4(fragPos, 1.0);
+    return fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+}
 
-// Shadow
-uniform sampler2D shadowMap;
-uniform bool enableShadows;
-uniform bool uUsePCF;
+#ifdef SHADOWS_EVSM
+// Warp exponents (must match shadow_moments.frag)
+const vec2 EVSM_EXPONENTS = vec2(40.0, 5.0);
+// Fraction of the Chebyshev bound treated as fully shadowed (light-bleeding reduction)
+const float EVSM_LIGHT_BLEED = 0.3;
 
-// Bloom threshold
-uniform float bloomThreshold;
+// One-tailed Chebyshev upper bound on the lit fraction
+float ChebyshevUpperBound(vec2 moments, float mean, float minVariance)
+{
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float d = mean - moments.x;
+    float pMax = clamp((variance / (variance + d * d) - EVSM_LIGHT_BLEED) / (1.0 - EVSM_LIGHT_BLEED), 0.0, 1.0);
+    return mean <= moments.x ? 1.0 : pMax;
+}
 
-// Shadow calculation (matching model.frag)
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir)
+// Fraction in shadow from the prefiltered moments: one trilinear fetch
+float EVSMShadow(vec2 uv, float layer, float depth)
 {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    projCoords = projCoords * 0.5 + 0.5;
+    vec4 moments = texture(shadowMap, vec3(uv, layer));
+    float warpedDepth = depth * 2.0 - 1.0;
+    vec2 warped = vec2(exp(EVSM_EXPONENTS.x * warpedDepth), -exp(-EVSM_EXPONENTS.y * warpedDepth));
     
+    // Variance floor scales with the warp's derivative to stay precision-safe
+    vec2 depthScale = 0.0001 * EVSM_EXPONENTS * abs(warped);
+    vec2 minVariance = depthScale * depthScale;
+    float positive = ChebyshevUpperBound(moments.xy, warped.x, minVariance.x);
+    float negative = ChebyshevUpperBound(moments.zw, warped.y, minVariance.y);
+    return 1.0 - min(positive, negative);
+}
+#else
+// Fraction of the filter footprint in shadow
+float FilterShadow(vec2 uv, float layer, float compareDepth)
+{
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    
+#if !defined(SHADOWS_PCF)
+    // Hard shadows: sampling the texel centre collapses the bilinear compare to one texel
+    vec2 texelCentre = (floor(uv / texelSize) + 0.5) * texelSize;
+    return 1.0 - texture(shadowMap, vec4(texelCentre, layer, compareDepth));
+#elif defined(PCF_LEGACY_LOOP)
+    // Reference: 7x7 kernel = 49 fetches + 49 compares (for GPU-time comparison)
+    float shadow = 0.0;
+    for(int x = -3; x <= 3; ++x) {
+        for(int y = -3; y <= 3; ++y) {
+            vec2 offset = vec2(x, y) * texelSize * PCF_SPREAD;
+            float pcfDepth = texture(shadowMap, vec3(uv + offset, layer)).r;
+            shadow += compareDepth > pcfDepth ? 1.0 : 0.0;
+        }
+    }
+    return shadow / 49.0;
+#elif defined(PCF_POISSON)
+    float angle = 6.2831853 * InterleavedGradientNoise(gl_FragCoord.xy);
+    vec2 rotation = vec2(cos(angle), sin(angle));
+    float radius = float(PCF_GRID) * PCF_SPREAD;
+    float lit = 0.0;
+    for (int i = 0; i < PCF_GRID * PCF_GRID; ++i) {
+        vec2 p = POISSON_DISK[i];
+        vec2 offset = vec2(p.x * rotation.x - p.y * rotation.y, p.x * rotation.y + p.y * rotation.x) * radius;
+        lit += texture(shadowMap, vec4(uv + offset * texelSize, layer, compareDepth));
+    }
+    return 1.0 - lit / float(PCF_GRID * PCF_GRID);
+#else
+    // Regular grid of bilinear taps two texels apart: N x N taps cover 2N x 2N texels
+    float lit = 0.0;
+    for (int y = 0; y < PCF_GRID; ++y) {
+        for (int x = 0; x < PCF_GRID; ++x) {
+            vec2 offset = (vec2(x, y) - 0.5 * float(PCF_GRID - 1)) * PCF_SPREAD;
+            lit += texture(shadowMap, vec4(uv + offset * texelSize, layer, compareDepth));
+        }
+    }
+    return 1.0 - lit / float(PCF_GRID * PCF_GRID);
+#endif
+}
+#endif
+
+// Shadow calculation (cascade selection + filtered lookup)
+float ShadowCalculation(vec3 fragPos, vec3 normal, vec3 lightDir)
+{
+    int cascade = SelectCascade(-(view * vec4(fragPos, 1.0)).z);
+    if (cascade < 0)
+        return 0.0;
+    
+    // Cascades refreshed on an amortised schedule may lag the camera by a few
+    // frames; a fragment outside its cascade's box falls through to the next
+    vec3 projCoords = ProjectToCascade(fragPos, cascade);
+    while (cascade + 1 < cascadeCount && any(greaterThan(abs(projCoords.xy - 0.5), vec2(0.5)))) {
+        cascade++;
+        projCoords = ProjectToCascade(fragPos, cascade);
+    }
+    
+    // Check if outside shadow map
     if(projCoords.z > 1.0)
         return 0.0;
     
-    float currentDepth = projCoords.z;
+#ifdef SHADOWS_EVSM
+    return EVSMShadow(projCoords.xy, float(cascade), projCoords.z);
+#else
     float bias = max(0.005 * (1.0 - dot(normal, lightDir)), 0.001);
     
-    float shadow = 0.0;
-    if (uUsePCF) {
-        vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-        for(int x = -3; x <= 3; ++x) {
-            for(int y = -3; y <= 3; ++y) {
-                float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-                shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-            }
+    return FilterShadow(projCoords.xy, float(cascade), projCoords.z - bias);
+#endif
+}
+#endif
+
+#ifdef AMBIENT_OCCLUSION
+// Half-resolution SSAO on unit 2 (bilateral upsample, see model.frag)
+uniform sampler2D ambientOcclusion;
+
+float SampleAmbientOcclusion(vec3 fragPos)
+{
+    float depth = -(view * vec4(fragPos, 1.0)).z;
+    ivec2 size = textureSize(ambientOcclusion, 0);
+    vec2 position = gl_FragCoord.xy * 0.5 - 0.5;
+    ivec2 base = ivec2(floor(position));
+    vec2 f = fract(position);
+
+    float total = 0.0;
+    float weightSum = 0.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            vec2 texel = texelFetch(ambientOcclusion, clamp(base + ivec2(x, y), ivec2(0), size - 1), 0).rg;
+            float bilinear = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y);
+            float weight = bilinear / (1.0e-3 + abs(texel.g - depth) / depth);
+            total += texel.r * weight;
+            weightSum += weight;
         }
-        shadow /= 49.0;
-    } else {
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
-        shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
     }
-    
-    return shadow;
+    return total / max(weightSum, 1.0e-5);
 }
+#endif
 
 void main()
 {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     
     // Sample building texture
-    vec3 albedo = texture(buildingTexture, TexCoords).rgb;
+    vec3 albedo = texture(buildingTextures, vec3(TexCoords, TextureLayer)).rgb;
     
     // Ambient
-    vec3 ambient = 0.3 * dirLightColor * albedo;
+    vec3 ambient = 0.3 * dirLightColor.rgb * albedo;
+#ifdef AMBIENT_OCCLUSION
+    ambient *= SampleAmbientOcclusion(FragPos);
+#endif
     
     // Directional light
-    vec3 lightDir = normalize(-dirLightDir);
+    vec3 lightDir = normalize(-dirLightDir.xyz);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * dirLightColor * albedo;
+    vec3 diffuse = diff * dirLightColor.rgb * albedo;
     
     // Specular (minimal for buildings)
     vec3 halfwayDir = normalize(lightDir + viewDir);
     float spec = pow(max(dot(norm, halfwayDir), 0.0), 16.0);
-    vec3 specular = spec * dirLightColor * 0.2;
+    vec3 specular = spec * dirLightColor.rgb * 0.2;
     
     // Shadow
     float shadow = 0.0;
-    if (enableShadows) {
-        shadow = ShadowCalculation(FragPosLightSpace, norm, lightDir);
-    }
+#ifdef SHADOWS
+    shadow = ShadowCalculation(FragPos, norm, lightDir);
+#endif
     
     vec3 dirResult = (ambient + (1.0 - shadow) * (diffuse + specular));
     
     // Point light
-    float distance = length(pointLightPos - FragPos);
-    float attenuation = 1.0 / (pointLightConstant + pointLightLinear * distance + 
-                               pointLightQuadratic * (distance * distance));
+    float distance = length(pointLightPos.xyz - FragPos);
+    float attenuation = 1.0 / (pointLightAttenuation.x + pointLightAttenuation.y * distance + 
+                               pointLightAttenuation.z * (distance * distance));
     
-    vec3 pointLightDir = normalize(pointLightPos - FragPos);
+    vec3 pointLightDir = normalize(pointLightPos.xyz - FragPos);
     float pointDiff = max(dot(norm, pointLightDir), 0.0);
-    vec3 pointDiffuse = pointDiff * pointLightColor * attenuation * albedo;
+    vec3 pointDiffuse = pointDiff * pointLightColor.rgb * attenuation * albedo;
     
     vec3 pointResult = pointDiffuse;
     
     // Combine
     vec3 color = dirResult + pointResult;
     
-    // Output to MRT
     FragColor = vec4(color, 1.0);
-    
-    // Brightness threshold for bloom
-    float brightness = dot(color, vec3(0.2126, 0.7152, 0.0722));
-    if (brightness > bloomThreshold) {
-        BrightColor = vec4(color, 1.0);
-    } else {
-        BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
-    }
 }
@@ -4,21 +4,43 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+// Per-instance attributes (one record per building, see BuildingInstance)
+layout (location = 3) in vec3 aInstancePos;
+layout (location = 4) in vec3 aInstanceScale;
+layout (location = 5) in float aTextureIndex;
+
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
-out vec4 FragPosLightSpace;
+flat out float TextureLayer;
+
+// Per-frame data shared by all scene programs (FrameUniforms, binding 0)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrices[4];   // One per shadow cascade
+    vec4 viewPos;                 // xyz
+    vec4 dirLightDir;             // xyz
+    vec4 dirLightColor;           // xyz
+    vec4 pointLightPos;           // xyz
+    vec4 pointLightColor;         // xyz
+    vec4 pointLightAttenuation;   // constant, linear, quadratic
+    vec4 cascadeSplits;           // View-space far distance of each cascade
+    int cascadeCount;
+};
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
-uniform vec3 buildingScale; // NEW: Pass building scale for UV tiling
+// The depth prepass (same vertex shader, no fragment work) must produce
+// bit-identical depth for the lit pass's GL_LEQUAL test
+invariant gl_Position;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Model matrix is translate * scale, so apply it directly
+    FragPos = aPos * aInstanceScale + aInstancePos;
+    
+    // Inverse-transpose of a pure scale is 1/scale (normalized in the fragment shader)
+    Normal = aNormal / aInstanceScale;
     
     // FIXED: Scale UVs based on building dimensions to prevent stretching
     // Vertical walls (front, back, left, right) tile based on height
@@ -26,23 +48,23 @@ void main()
     vec2 scaledUVs = aTexCoords;
     
     // Detect which face we're on based on normal direction
-    vec3 worldNormal = mat3(transpose(inverse(model))) * aNormal;
-    vec3 absNormal = abs(worldNormal);
+    // (scale never flips an axis, so the object-space normal is enough)
+    vec3 absNormal = abs(aNormal);
     
     // Vertical faces (walls) - tile vertically based on height
     if (absNormal.y < 0.5) {
         // Side walls: scale V coordinate by height for proper tiling
-        scaledUVs.y = aTexCoords.y * buildingScale.y * 0.5; // 0.5 = tiling frequency
-        scaledUVs.x = aTexCoords.x * max(buildingScale.x, buildingScale.z) * 0.5;
+        scaledUVs.y = aTexCoords.y * aInstanceScale.y * 0.5; // 0.5 = tiling frequency
+        scaledUVs.x = aTexCoords.x * max(aInstanceScale.x, aInstanceScale.z) * 0.5;
     }
     // Horizontal faces (top/bottom) - tile based on width/depth
     else {
-        scaledUVs.x = aTexCoords.x * buildingScale.x * 0.5;
-        scaledUVs.y = aTexCoords.y * buildingScale.z * 0.5;
+        scaledUVs.x = aTexCoords.x * aInstanceScale.x * 0.5;
+        scaledUVs.y = aTexCoords.y * aInstanceScale.z * 0.5;
     }
     
     TexCoords = scaledUVs;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
+    TextureLayer = aTextureIndex;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -0,0 +1,14 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+
+// Per-instance attributes (one record per building, see BuildingInstance)
+layout (location = 3) in vec3 aInstancePos;
+layout (location = 4) in vec3 aInstanceScale;
+
+uniform mat4 lightSpaceMatrix;
+
+void main()
+{
+    gl_Position = lightSpaceMatrix * vec4(aPos * aInstanceScale + aInstancePos, 1.0);
+}
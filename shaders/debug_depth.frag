@@ -4,12 +4,13 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
-uniform sampler2D shadowMap;
+uniform sampler2DArray shadowMap;
+uniform int cascade;
 
 void main()
 {
-    // Sample depth from shadow map
-    float depthValue = texture(shadowMap, TexCoords).r;
+    // Sample depth from one cascade of the shadow map
+    float depthValue = texture(shadowMap, vec3(TexCoords, float(cascade))).r;
     
     // Simple visualization (no complex math)
     float visualDepth = 1.0 - depthValue;
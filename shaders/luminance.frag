@@ -0,0 +1,22 @@
+#version 330 core
+out float LogLuminance;
+
+in vec2 TexCoords;
+
+uniform sampler2D hdrBuffer;
+uniform vec2 texelSize;  // One texel of the luminance target in UV
+
+void main()
+{
+    // 2x2 bilinear taps spread over this texel's footprint of the scene
+    vec2 offset = texelSize * 0.25;
+    vec3 color = texture(hdrBuffer, TexCoords + vec2(-offset.x, -offset.y)).rgb
+               + texture(hdrBuffer, TexCoords + vec2( offset.x, -offset.y)).rgb
+               + texture(hdrBuffer, TexCoords + vec2(-offset.x,  offset.y)).rgb
+               + texture(hdrBuffer, TexCoords + vec2( offset.x,  offset.y)).rgb;
+    float luminance = dot(color * 0.25, vec3(0.2126, 0.7152, 0.0722));
+
+    // Averaging logs gives the geometric mean, so a few very bright pixels
+    // (the sun, emissive windows) do not dominate the exposure
+    LogLuminance = log(max(luminance, 1.0e-4));
+}
@@ -7,19 +7,34 @@ layout (location = 2) in vec2 aTexCoords;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
-out vec4 FragPosLightSpace;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+
+// Per-frame data shared by all scene programs (FrameUniforms, binding 0)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrices[4];   // One per shadow cascade
+    vec4 viewPos;                 // xyz
+    vec4 dirLightDir;             // xyz
+    vec4 dirLightColor;           // xyz
+    vec4 pointLightPos;           // xyz
+    vec4 pointLightColor;         // xyz
+    vec4 pointLightAttenuation;   // constant, linear, quadratic
+    vec4 cascadeSplits;           // View-space far distance of each cascade
+    int cascadeCount;
+};
+
+// The depth prepass (same vertex shader, no fragment work) must produce
+// bit-identical depth for the lit pass's GL_LEQUAL test
+invariant gl_Position;
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;  
     TexCoords = aTexCoords;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
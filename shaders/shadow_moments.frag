@@ -0,0 +1,23 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// Shadow depth array, read raw (ShadowMap binds its non-comparing sampler)
+uniform sampler2DArray depthMap;
+uniform int cascade;
+
+// Warp exponents (must match SHADOWS_EVSM in model.frag / building.frag).
+// 40 keeps exp(2 * 40) inside RGBA32F range.
+const vec2 EVSM_EXPONENTS = vec2(40.0, 5.0);
+
+void main()
+{
+    // Depth mapped to [-1, 1] before warping, as in the scene shaders
+    float depth = texture(depthMap, vec3(TexCoords, float(cascade))).r * 2.0 - 1.0;
+    
+    float positive = exp(EVSM_EXPONENTS.x * depth);
+    float negative = -exp(-EVSM_EXPONENTS.y * depth);
+    FragColor = vec4(positive, positive * positive, negative, negative * negative);
+}
@@ -4,12 +4,25 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Per-frame data shared by all scene programs (FrameUniforms, binding 0)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrices[4];   // One per shadow cascade
+    vec4 viewPos;                 // xyz
+    vec4 dirLightDir;             // xyz
+    vec4 dirLightColor;           // xyz
+    vec4 pointLightPos;           // xyz
+    vec4 pointLightColor;         // xyz
+    vec4 pointLightAttenuation;   // constant, linear, quadratic
+    vec4 cascadeSplits;           // View-space far distance of each cascade
+    int cascadeCount;
+};
 
 void main()
 {
     TexCoords = aPos;
-    vec4 pos = projection * view * vec4(aPos, 1.0);
+    vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
     gl_Position = pos.xyww;  // Ensure skybox is always at maximum depth
 }
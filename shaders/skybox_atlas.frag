@@ -1,8 +1,7 @@
 #version 330 core
 
-// MRT outputs for HDR + Bloom compatibility
+// HDR color (same target as the model shader)
 layout(location = 0) out vec4 FragColor;
-layout(location = 1) out vec4 BrightColor;
 
 in vec2 TexCoords;
 
@@ -11,10 +10,5 @@ uniform sampler2D skyboxAtlas;
 void main()
 {
     vec3 color = texture(skyboxAtlas, TexCoords).rgb;
-    
-    // Output to MRT
     FragColor = vec4(color, 1.0);
-    
-    // Skybox doesn't contribute to bloom
-    BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
 }
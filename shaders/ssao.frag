@@ -0,0 +1,73 @@
+#version 330 core
+out vec2 Occlusion;  // r = ambient visibility (1 = unoccluded), g = linear view depth
+
+in vec2 TexCoords;
+
+uniform sampler2D depthBuffer;  // Scene depth at render resolution
+uniform mat4 projection;        // Projection the depth was rendered with
+uniform mat4 invProjection;
+uniform vec2 depthTexelSize;    // One texel of the depth buffer in UV
+uniform float radius;           // Sampling radius in world units
+uniform float intensity;        // Exponent on the visibility
+
+const int SAMPLE_COUNT = 12;
+
+vec3 ViewPosition(vec2 uv)
+{
+    vec4 clip = vec4(uv * 2.0 - 1.0, texture(depthBuffer, uv).r * 2.0 - 1.0, 1.0);
+    vec4 position = invProjection * clip;
+    return position.xyz / position.w;
+}
+
+// View-space z (negative in front of the camera) from a depth-buffer value
+float ViewDepth(float depth)
+{
+    return -projection[3][2] / ((depth * 2.0 - 1.0) + projection[2][2]);
+}
+
+float InterleavedGradientNoise(vec2 position)
+{
+    return fract(52.9829189 * fract(dot(position, vec2(0.06711056, 0.00583715))));
+}
+
+void main()
+{
+    vec3 center = ViewPosition(TexCoords);
+
+    // Normal from the neighbouring depths; the smaller difference on each
+    // axis keeps silhouettes from bending it
+    vec3 right = ViewPosition(TexCoords + vec2(depthTexelSize.x, 0.0)) - center;
+    vec3 left = center - ViewPosition(TexCoords - vec2(depthTexelSize.x, 0.0));
+    vec3 up = ViewPosition(TexCoords + vec2(0.0, depthTexelSize.y)) - center;
+    vec3 down = center - ViewPosition(TexCoords - vec2(0.0, depthTexelSize.y));
+    vec3 dx = abs(right.z) < abs(left.z) ? right : left;
+    vec3 dy = abs(up.z) < abs(down.z) ? up : down;
+    vec3 normal = normalize(cross(dx, dy));
+
+    // Hemisphere around the normal, rotated per pixel; the bilateral blur
+    // averages the rotation pattern away
+    float angle = 6.2831853 * InterleavedGradientNoise(gl_FragCoord.xy);
+    vec3 randomDir = vec3(cos(angle), sin(angle), 0.0);
+    vec3 tangent = normalize(randomDir - normal * dot(randomDir, normal));
+    mat3 tbn = mat3(tangent, cross(normal, tangent), normal);
+
+    float occlusion = 0.0;
+    for (int i = 0; i < SAMPLE_COUNT; ++i) {
+        // Golden-angle spiral, denser close to the surface
+        float t = (float(i) + 0.5) / float(SAMPLE_COUNT);
+        float phi = float(i) * 2.3999632;
+        vec3 direction = vec3(sqrt(t) * cos(phi), sqrt(t) * sin(phi), sqrt(1.0 - t));
+        vec3 samplePos = center + tbn * direction * radius * mix(0.1, 1.0, t * t);
+
+        vec4 offset = projection * vec4(samplePos, 1.0);
+        vec2 sampleUV = offset.xy / offset.w * 0.5 + 0.5;
+        float sceneDepth = ViewDepth(texture(depthBuffer, sampleUV).r);
+
+        // Occluders far in front of the sample (another building) fade out
+        float rangeCheck = smoothstep(0.0, 1.0, radius / abs(center.z - sceneDepth));
+        occlusion += (sceneDepth >= samplePos.z + 0.02 ? 1.0 : 0.0) * rangeCheck;
+    }
+
+    float visibility = pow(1.0 - occlusion / float(SAMPLE_COUNT), intensity);
+    Occlusion = vec2(visibility, -center.z);
+}
@@ -0,0 +1,30 @@
+#version 330 core
+out vec2 Occlusion;
+
+in vec2 TexCoords;
+
+uniform sampler2D occlusionBuffer;  // r = visibility, g = linear view depth
+uniform vec2 direction;             // One texel along the blur axis
+
+const int BLUR_RADIUS = 3;
+const float DEPTH_TOLERANCE = 0.05;  // Relative depth difference that stops the blur
+
+void main()
+{
+    // Depth-aware Gaussian: taps on another surface get no weight, so
+    // occlusion stays on its own side of an edge
+    vec2 center = texture(occlusionBuffer, TexCoords).rg;
+    float total = center.r;
+    float weightSum = 1.0;
+    for (int i = -BLUR_RADIUS; i <= BLUR_RADIUS; ++i) {
+        if (i == 0) continue;
+        vec2 tap = texture(occlusionBuffer, TexCoords + direction * float(i)).rg;
+        float spatial = exp(-float(i * i) / 8.0);
+        float range = max(0.0, 1.0 - abs(tap.g - center.g) / (DEPTH_TOLERANCE * center.g));
+        total += tap.r * spatial * range;
+        weightSum += spatial * range;
+    }
+
+    // Depth passes through for the upsample in the scene shaders
+    Occlusion = vec2(total / weightSum, center.g);
+}
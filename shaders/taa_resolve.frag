@@ -0,0 +1,48 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D currentColor;    // Scene at render resolution, jittered
+uniform sampler2D velocityBuffer;  // Render resolution, UV offset to the previous frame
+uniform sampler2D history;         // Previous resolve at output resolution
+uniform vec2 jitter;               // This frame's projection offset (NDC)
+uniform vec2 renderTexelSize;      // One texel of the scene target in UV
+uniform float historyWeight;       // 0 discards the history (first frame, resize)
+
+// Luminance-based weights keep single very bright samples from flickering
+float ToneWeight(vec3 color)
+{
+    return 1.0 / (1.0 + dot(color, vec3(0.2126, 0.7152, 0.0722)));
+}
+
+void main()
+{
+    // Where this output pixel's content landed in the jittered scene
+    vec2 uv = TexCoords + jitter * 0.5;
+    vec3 current = texture(currentColor, uv).rgb;
+
+    // Colour range of the current neighbourhood: history outside it is stale
+    // (disocclusion, moving objects, lighting changes) and is clamped into it
+    vec3 boxMin = current;
+    vec3 boxMax = current;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            vec3 neighbour = texture(currentColor, uv + vec2(x, y) * renderTexelSize).rgb;
+            boxMin = min(boxMin, neighbour);
+            boxMax = max(boxMax, neighbour);
+        }
+    }
+
+    vec2 prevUV = TexCoords - texture(velocityBuffer, uv).rg;
+    float weight = historyWeight;
+    if (any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) {
+        weight = 0.0;  // Came from off screen: nothing to accumulate
+    }
+    vec3 previous = clamp(texture(history, prevUV).rgb, boxMin, boxMax);
+
+    float currentWeight = (1.0 - weight) * ToneWeight(current);
+    float previousWeight = weight * ToneWeight(previous);
+    vec3 color = (current * currentWeight + previous * previousWeight) / max(currentWeight + previousWeight, 1.0e-5);
+    FragColor = vec4(color, 1.0);
+}
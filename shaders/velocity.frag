@@ -0,0 +1,33 @@
+#version 330 core
+out vec2 Velocity;
+
+in vec2 TexCoords;
+
+uniform sampler2D depthBuffer;
+uniform mat4 invViewProjection;   // This frame, without jitter
+uniform mat4 prevViewProjection;  // Previous frame, without jitter
+uniform vec2 jitter;              // This frame's projection offset (NDC)
+uniform vec2 texelSize;           // One texel of the scene target in UV
+
+void main()
+{
+    // Closest depth of the 3x3 neighbourhood: silhouette pixels take the
+    // foreground's motion, which keeps edges from trailing the background
+    float depth = 1.0;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            depth = min(depth, texture(depthBuffer, TexCoords + vec2(x, y) * texelSize).r);
+        }
+    }
+
+    // Scene texels sit at jittered positions; unproject from the unjittered one
+    vec2 ndc = TexCoords * 2.0 - 1.0 - jitter;
+    vec4 world = invViewProjection * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+    world /= world.w;
+
+    // Camera motion only: objects that move on their own rely on the
+    // resolve's neighbourhood clamp
+    vec4 prevClip = prevViewProjection * world;
+    vec2 prevUV = prevClip.xy / prevClip.w * 0.5 + 0.5;
+    Velocity = (ndc * 0.5 + 0.5) - prevUV;
+}
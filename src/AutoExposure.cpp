@@ -0,0 +1,167 @@
+#include "AutoExposure.h"
+#include "GLState.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // Exposure limits, so a black or blown-out frame cannot run away
+    const float MIN_EXPOSURE = 0.05f;
+    const float MAX_EXPOSURE = 20.0f;
+}
+
+AutoExposure::AutoExposure()
+    : texture(0), fbo(0), topLevel(0), current(0), frame(0), initialized(false),
+      keyValue(0.18f), adaptationSpeed(1.5f), averageLuminance(0.0f), targetExposure(1.0f),
+      exposure(1.0f), hasResult(false), readbackCpuMs(0.0), skippedReductions(0), readbackLatency(0)
+{
+    for (int i = 0; i < READBACK_COUNT; ++i)
+    {
+        packBuffers[i] = 0;
+        fences[i] = 0;
+        issuedFrame[i] = 0;
+    }
+}
+
+AutoExposure::~AutoExposure()
+{
+    Cleanup();
+}
+
+void AutoExposure::Initialize()
+{
+    if (initialized) return;
+
+    // Log luminance in a single channel; 16-bit float holds log(1e-4) .. log(65504)
+    glGenTextures(1, &texture);
+    GLState::BindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, SIZE, SIZE, 0, GL_RED, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    topLevel = static_cast<int>(std::log2(static_cast<float>(SIZE)));
+
+    glGenFramebuffers(1, &fbo);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[AutoExposure] ERROR: Luminance framebuffer incomplete" << std::endl;
+    }
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // One float per readback
+    glGenBuffers(READBACK_COUNT, packBuffers);
+    for (int i = 0; i < READBACK_COUNT; ++i)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(float), NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    gpuTimer.Initialize();
+    initialized = true;
+    std::cout << "[AutoExposure] " << SIZE << "x" << SIZE << " log-luminance target, "
+              << READBACK_COUNT << " readback buffers" << std::endl;
+}
+
+void AutoExposure::Cleanup()
+{
+    if (!initialized) return;
+
+    for (int i = 0; i < READBACK_COUNT; ++i)
+    {
+        if (fences[i]) glDeleteSync(fences[i]);
+        fences[i] = 0;
+    }
+    glDeleteBuffers(READBACK_COUNT, packBuffers);
+    for (int i = 0; i < READBACK_COUNT; ++i)
+    {
+        packBuffers[i] = 0;
+    }
+    if (fbo) GLState::DeleteFramebuffers(1, &fbo);
+    if (texture) GLState::DeleteTextures(1, &texture);
+    fbo = texture = 0;
+    gpuTimer.Cleanup();
+
+    current = 0;
+    hasResult = false;
+    initialized = false;
+}
+
+void AutoExposure::Reduce()
+{
+    if (!initialized) return;
+
+    // The oldest buffer has not been read yet: skip rather than wait for it
+    if (fences[current])
+    {
+        skippedReductions++;
+        return;
+    }
+
+    // Averaging mips: the 1x1 level holds the mean log luminance
+    GLState::BindTexture(GL_TEXTURE_2D, texture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // With a pack buffer bound the copy is queued, not waited on
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[current]);
+    glGetTexImage(GL_TEXTURE_2D, topLevel, GL_RED, GL_FLOAT, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    issuedFrame[current] = frame;
+    current = (current + 1) % READBACK_COUNT;
+}
+
+void AutoExposure::Update(float deltaTime)
+{
+    if (!initialized) return;
+
+    frame++;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Fences signal in submission order, starting with the oldest slot
+    for (int i = 0; i < READBACK_COUNT; ++i)
+    {
+        int index = (current + i) % READBACK_COUNT;
+        if (!fences[index]) continue;
+
+        // Zero timeout: only asks whether the copy has finished
+        GLenum status = glClientWaitSync(fences[index], 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        Collect(index);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    readbackCpuMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    if (!hasResult) return;
+
+    // Exponential approach in log space, so brightening and darkening by the
+    // same factor take the same time regardless of frame rate
+    float blend = 1.0f - std::exp(-deltaTime * adaptationSpeed);
+    exposure = std::exp(std::log(exposure) + (std::log(targetExposure) - std::log(exposure)) * blend);
+}
+
+void AutoExposure::Collect(int index)
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[index]);
+    const float* data = static_cast<const float*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(float), GL_MAP_READ_BIT));
+    if (data)
+    {
+        averageLuminance = std::exp(*data);
+        targetExposure = std::max(MIN_EXPOSURE, std::min(keyValue / std::max(averageLuminance, 1.0e-4f), MAX_EXPOSURE));
+        hasResult = true;
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glDeleteSync(fences[index]);
+    fences[index] = 0;
+    readbackLatency = frame - issuedFrame[index];
+}
@@ -1,17 +1,23 @@
 #include "Building.h"
+#include "GLState.h"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <stb_image.h>
 #include <iostream>
 #include <filesystem>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define BUILDING_PACK_SSE 1
+#endif
+
 // Static member initialization
 unsigned int Building::VAO = 0;
 unsigned int Building::VBO = 0;
 bool Building::geometryInitialized = false;
 
-Building::Building(const glm::vec3& pos, const glm::vec3& scl, unsigned int texID)
-    : position(pos), scale(scl), textureID(texID)
+Building::Building(const glm::vec3& pos, const glm::vec3& scl, unsigned int texIndex)
+    : position(pos), scale(scl), textureIndex(texIndex)
 {
 }
 
@@ -23,6 +29,73 @@ glm::mat4 Building::GetModelMatrix() const
     return model;
 }
 
+BuildingInstance Building::GetInstanceData() const
+{
+    return BuildingInstance{ position, scale, static_cast<float>(textureIndex) };
+}
+
+void BuildingSoA::Clear()
+{
+    px.clear(); py.clear(); pz.clear();
+    sx.clear(); sy.clear(); sz.clear();
+    tex.clear();
+}
+
+void BuildingSoA::Reserve(size_t count)
+{
+    px.reserve(count); py.reserve(count); pz.reserve(count);
+    sx.reserve(count); sy.reserve(count); sz.reserve(count);
+    tex.reserve(count);
+}
+
+void BuildingSoA::Push(const glm::vec3& position, const glm::vec3& scale, float textureLayer)
+{
+    px.push_back(position.x); py.push_back(position.y); pz.push_back(position.z);
+    sx.push_back(scale.x); sy.push_back(scale.y); sz.push_back(scale.z);
+    tex.push_back(textureLayer);
+}
+
+void Building::PackInstances(const BuildingSoA& soa, BuildingInstance* out)
+{
+    const size_t count = soa.Size();
+    float* dst = reinterpret_cast<float*>(out);
+    size_t i = 0;
+    
+#if defined(BUILDING_PACK_SSE)
+    // Transpose 4 buildings into 4 x (px,py,pz,sx) and 4 x (sy,sz,tex,-) rows.
+    // Each record is written as two 4-wide stores; the second spills one float
+    // into the next record, which the next store overwrites. The final batch
+    // therefore stops one short of the end and the tail is handled below.
+    for (; i + 4 < count; i += 4)
+    {
+        __m128 r0 = _mm_loadu_ps(&soa.px[i]);
+        __m128 r1 = _mm_loadu_ps(&soa.py[i]);
+        __m128 r2 = _mm_loadu_ps(&soa.pz[i]);
+        __m128 r3 = _mm_loadu_ps(&soa.sx[i]);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        
+        __m128 q0 = _mm_loadu_ps(&soa.sy[i]);
+        __m128 q1 = _mm_loadu_ps(&soa.sz[i]);
+        __m128 q2 = _mm_loadu_ps(&soa.tex[i]);
+        __m128 q3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+        
+        float* record = dst + i * 7;
+        _mm_storeu_ps(record +  0, r0); _mm_storeu_ps(record +  4, q0);
+        _mm_storeu_ps(record +  7, r1); _mm_storeu_ps(record + 11, q1);
+        _mm_storeu_ps(record + 14, r2); _mm_storeu_ps(record + 18, q2);
+        _mm_storeu_ps(record + 21, r3); _mm_storeu_ps(record + 25, q3);
+    }
+#endif
+    
+    for (; i < count; ++i)
+    {
+        out[i].position = glm::vec3(soa.px[i], soa.py[i], soa.pz[i]);
+        out[i].scale = glm::vec3(soa.sx[i], soa.sy[i], soa.sz[i]);
+        out[i].textureIndex = soa.tex[i];
+    }
+}
+
 void Building::SetupCubeWithUVs()
 {
     // Cube vertices with positions, normals, and UVs
@@ -81,7 +154,7 @@ void Building::SetupCubeWithUVs()
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     
@@ -97,8 +170,16 @@ void Building::SetupCubeWithUVs()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
     
+    // Instance attributes (position, scale, texture index) - one record per building.
+    // Pointers are set in RenderInstanced() since they depend on the instance buffer.
+    for (unsigned int loc = 3; loc <= 5; ++loc)
+    {
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
     
     std::cout << "[Building] Cube geometry initialized with UVs" << std::endl;
 }
@@ -116,7 +197,7 @@ void Building::CleanupGeometry()
 {
     if (geometryInitialized)
     {
-        glDeleteVertexArrays(1, &VAO);
+        GLState::DeleteVertexArrays(1, &VAO);
         glDeleteBuffers(1, &VBO);
         VAO = 0;
         VBO = 0;
@@ -124,21 +205,26 @@ void Building::CleanupGeometry()
     }
 }
 
-void Building::RenderGeometry()
+void Building::RenderInstanced(unsigned int instanceVBO, size_t firstInstance, size_t instanceCount)
 {
-    if (geometryInitialized)
-    {
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
-    }
+    if (!geometryInitialized || instanceVBO == 0 || instanceCount == 0) return;
+    
+    GLState::BindVertexArray(VAO);
+    
+    // Point the instance attributes at the requested range (GL 3.3 has no base-instance draw)
+    const GLsizei stride = sizeof(BuildingInstance);
+    const size_t base = firstInstance * sizeof(BuildingInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BuildingInstance, position)));
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BuildingInstance, scale)));
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BuildingInstance, textureIndex)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, static_cast<GLsizei>(instanceCount));
 }
 
-unsigned int Building::LoadBuildingTexture(const char* path)
+bool Building::LoadBuildingImage(const char* path, FacadeImage& image)
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    
     int width, height, nrChannels;
     
     // Enable vertical flip for 2D facade textures (proper UV orientation)
@@ -151,51 +237,116 @@ unsigned int Building::LoadBuildingTexture(const char* path)
     std::cout << "[Building]   Absolute path: " << absPath << std::endl;
     std::cout << "[Building]   File exists: " << (std::filesystem::exists(absPath) ? "YES" : "NO") << std::endl;
     
-    unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
+    // Always expand to RGBA so every layer of the facade array shares one format
+    unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 4);
     
     if (data)
     {
-        GLenum format = GL_RGB;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-        
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        
-        // IMPROVED: Better texture filtering to prevent stretching artifacts
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        // Note: Anisotropic filtering would be enabled here if GLAD was regenerated with EXT_texture_filter_anisotropic
-        // For now, mipmaps + UV tiling in shader will prevent most stretching artifacts
-        
+        image.width = width;
+        image.height = height;
+        image.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
         stbi_image_free(data);
         
         std::cout << "[Building]   SUCCESS!" << std::endl;
         std::cout << "[Building]   Resolution: " << width << "x" << height << std::endl;
-        std::cout << "[Building]   Channels: " << nrChannels << " (format: ";
-        if (format == GL_RED) std::cout << "RED";
-        else if (format == GL_RGB) std::cout << "RGB";
-        else if (format == GL_RGBA) std::cout << "RGBA";
-        std::cout << ")" << std::endl;
-        
-        return textureID;
+        std::cout << "[Building]   Channels: " << nrChannels << " (expanded to RGBA)" << std::endl;
+        return true;
     }
     else
     {
         const char* reason = stbi_failure_reason();
         std::cerr << "[Building]   FAILED!" << std::endl;
         std::cerr << "[Building]   STB Error: " << (reason ? reason : "Unknown") << std::endl;
+        return false;
+    }
+}
+
+FacadeImage Building::ResizeImage(const FacadeImage& src, int width, int height)
+{
+    if (src.width == width && src.height == height) return src;
+    
+    FacadeImage dst;
+    dst.width = width;
+    dst.height = height;
+    dst.pixels.resize(static_cast<size_t>(width) * height * 4);
+    
+    // Bilinear resample (texel centres aligned); only runs once at load time
+    const float sx = static_cast<float>(src.width) / width;
+    const float sy = static_cast<float>(src.height) / height;
+    for (int y = 0; y < height; ++y)
+    {
+        float fy = glm::clamp((y + 0.5f) * sy - 0.5f, 0.0f, static_cast<float>(src.height - 1));
+        int y0 = static_cast<int>(fy);
+        int y1 = glm::min(y0 + 1, src.height - 1);
+        float ty = fy - y0;
         
-        stbi_image_free(data);
-        glDeleteTextures(1, &textureID);
-        return 0; // Return 0 to indicate failure
+        for (int x = 0; x < width; ++x)
+        {
+            float fx = glm::clamp((x + 0.5f) * sx - 0.5f, 0.0f, static_cast<float>(src.width - 1));
+            int x0 = static_cast<int>(fx);
+            int x1 = glm::min(x0 + 1, src.width - 1);
+            float tx = fx - x0;
+            
+            for (int c = 0; c < 4; ++c)
+            {
+                float p00 = src.pixels[(static_cast<size_t>(y0) * src.width + x0) * 4 + c];
+                float p10 = src.pixels[(static_cast<size_t>(y0) * src.width + x1) * 4 + c];
+                float p01 = src.pixels[(static_cast<size_t>(y1) * src.width + x0) * 4 + c];
+                float p11 = src.pixels[(static_cast<size_t>(y1) * src.width + x1) * 4 + c];
+                float top = p00 + (p10 - p00) * tx;
+                float bottom = p01 + (p11 - p01) * tx;
+                dst.pixels[(static_cast<size_t>(y) * width + x) * 4 + c] =
+                    static_cast<unsigned char>(top + (bottom - top) * ty + 0.5f);
+            }
+        }
+    }
+    
+    return dst;
+}
+
+unsigned int Building::CreateFacadeTextureArray(const std::vector<FacadeImage>& layers)
+{
+    if (layers.empty()) return 0;
+    
+    // Common resolution: the largest facade, capped to keep the array small
+    int width = 1, height = 1;
+    for (const auto& layer : layers)
+    {
+        width = glm::max(width, layer.width);
+        height = glm::max(height, layer.height);
+    }
+    width = glm::min(width, MAX_FACADE_RESOLUTION);
+    height = glm::min(height, MAX_FACADE_RESOLUTION);
+    
+    unsigned int textureArray;
+    glGenTextures(1, &textureArray);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, static_cast<GLsizei>(layers.size()),
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    
+    for (size_t i = 0; i < layers.size(); ++i)
+    {
+        FacadeImage layer = ResizeImage(layers[i], width, height);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(i), width, height, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, layer.pixels.data());
     }
+    
+    // Full mip chain for every layer
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    
+    // IMPROVED: Better texture filtering to prevent stretching artifacts
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    
+    // Note: Anisotropic filtering would be enabled here if GLAD was regenerated with EXT_texture_filter_anisotropic
+    // For now, mipmaps + UV tiling in shader will prevent most stretching artifacts
+    
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    
+    std::cout << "[Building] Facade texture array created: " << layers.size() << " layers at "
+              << width << "x" << height << " (mipmapped)" << std::endl;
+    
+    return textureArray;
 }
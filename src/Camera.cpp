@@ -5,6 +5,7 @@ Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
     , MovementSpeed(2.5f)
     , MouseSensitivity(0.1f)
     , Zoom(45.0f)
+    , Jitter(0.0f)
 {
     Position = position;
     WorldUp = up;
@@ -23,6 +24,73 @@ glm::mat4 Camera::GetProjectionMatrix(float aspectRatio, float near, float far)
     return glm::perspective(glm::radians(Zoom), aspectRatio, near, far);
 }
 
+glm::mat4 Camera::GetJitteredProjectionMatrix(float aspectRatio, float near, float far) const
+{
+    // The z column scales with z_view and clip w = -z_view, so subtracting here
+    // offsets clip x/y by Jitter * w, i.e. the image moves by +Jitter after the divide
+    glm::mat4 projection = GetProjectionMatrix(aspectRatio, near, far);
+    projection[2][0] -= Jitter.x;
+    projection[2][1] -= Jitter.y;
+    return projection;
+}
+
+void Camera::SetJitterSample(unsigned int frameIndex, unsigned int width, unsigned int height)
+{
+    // Radical inverse in the given base: a low-discrepancy sequence in [0, 1)
+    auto halton = [](unsigned int index, unsigned int base)
+    {
+        float result = 0.0f;
+        float fraction = 1.0f;
+        while (index > 0)
+        {
+            fraction /= static_cast<float>(base);
+            result += fraction * static_cast<float>(index % base);
+            index /= base;
+        }
+        return result;
+    };
+
+    // Index 0 of the sequence is (0, 0); start at 1 so every phase is distinct
+    unsigned int index = frameIndex % JITTER_PHASES + 1;
+    glm::vec2 pixelOffset(halton(index, 2) - 0.5f, halton(index, 3) - 0.5f);
+    Jitter = glm::vec2(2.0f * pixelOffset.x / static_cast<float>(width),
+                       2.0f * pixelOffset.y / static_cast<float>(height));
+}
+
+FrustumPlanes Camera::ExtractFrustumPlanes(const glm::mat4& viewProjection)
+{
+    // Gribb-Hartmann: planes are sums/differences of the matrix rows
+    // (glm is column-major, so row i is m[0][i], m[1][i], m[2][i], m[3][i])
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    FrustumPlanes frustum;
+    frustum.planes[0] = row3 + row0;  // Left
+    frustum.planes[1] = row3 - row0;  // Right
+    frustum.planes[2] = row3 + row1;  // Bottom
+    frustum.planes[3] = row3 - row1;  // Top
+    frustum.planes[4] = row3 + row2;  // Near
+    frustum.planes[5] = row3 - row2;  // Far
+
+    // Normalize so plane distances are in world units
+    for (auto& plane : frustum.planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+            plane /= length;
+    }
+
+    return frustum;
+}
+
+FrustumPlanes Camera::GetFrustumPlanes(float aspectRatio, float near, float far) const
+{
+    return ExtractFrustumPlanes(GetProjectionMatrix(aspectRatio, near, far) * GetViewMatrix());
+}
+
 void Camera::updateCameraVectors()
 {
     // Calculate the new Front vector
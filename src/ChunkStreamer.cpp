@@ -0,0 +1,129 @@
+#include "ChunkStreamer.h"
+#include <algorithm>
+#include <iostream>
+
+ChunkStreamer::ChunkStreamer(GenerateFn generate, unsigned int workerCount)
+    : generateChunk(std::move(generate)), stopping(false), completedHead(nullptr)
+{
+    if (workerCount == 0)
+    {
+        // Leave one core for the render thread
+        unsigned int hw = std::thread::hardware_concurrency();
+        workerCount = std::clamp(hw > 1 ? hw - 1 : 1u, 1u, 4u);
+    }
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(&ChunkStreamer::WorkerLoop, this);
+    }
+
+    std::cout << "[ChunkStreamer] Started " << workerCount << " worker thread(s)" << std::endl;
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobAvailable.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable()) worker.join();
+    }
+
+    // Free anything the render thread never collected
+    CompletedNode* node = completedHead.exchange(nullptr, std::memory_order_acquire);
+    while (node)
+    {
+        CompletedNode* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void ChunkStreamer::Request(int chunkX, int chunkZ, int seed, unsigned int generation)
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back({ chunkX, chunkZ, seed, generation });
+    }
+    jobAvailable.notify_one();
+}
+
+void ChunkStreamer::CancelPending(const std::function<bool(int chunkX, int chunkZ)>& shouldCancel)
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                              [&](const Job& job) { return shouldCancel(job.chunkX, job.chunkZ); }),
+               jobs.end());
+}
+
+size_t ChunkStreamer::GetQueuedCount() const
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    return jobs.size();
+}
+
+void ChunkStreamer::WorkerLoop()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+
+        CompletedNode* node = new CompletedNode();
+        node->chunk.chunkX = job.chunkX;
+        node->chunk.chunkZ = job.chunkZ;
+        node->chunk.generation = job.generation;
+        node->chunk.buildings = generateChunk(job.chunkX, job.chunkZ, job.seed);
+        PushCompleted(node);
+    }
+}
+
+void ChunkStreamer::PushCompleted(CompletedNode* node)
+{
+    // Treiber push; the consumer only ever takes the whole stack at once,
+    // so there is no ABA hazard
+    CompletedNode* head = completedHead.load(std::memory_order_relaxed);
+    do
+    {
+        node->next = head;
+    } while (!completedHead.compare_exchange_weak(head, node,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+}
+
+size_t ChunkStreamer::PollCompleted(std::vector<CompletedChunk>& out, size_t maxCount)
+{
+    // Grab everything finished so far; the stack is LIFO, so reverse into FIFO order
+    CompletedNode* node = completedHead.exchange(nullptr, std::memory_order_acquire);
+    std::vector<CompletedNode*> taken;
+    while (node)
+    {
+        taken.push_back(node);
+        node = node->next;
+    }
+    for (auto it = taken.rbegin(); it != taken.rend(); ++it)
+    {
+        ready.push_back(std::move((*it)->chunk));
+        delete *it;
+    }
+
+    size_t count = 0;
+    while (count < maxCount && !ready.empty())
+    {
+        out.push_back(std::move(ready.front()));
+        ready.pop_front();
+        ++count;
+    }
+    return count;
+}
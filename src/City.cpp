@@ -1,15 +1,20 @@
 #include "City.h"
-#include "City.h"
+#include "GLState.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <filesystem>
+#include <sstream>
+#include <limits>
 
 City::City()
-    : shaderProgram(0), enabled(true), initialized(false)
+    : facadeTextureArray(0), facadeLayerCount(0), instanceVBO(0), instanceCount(0), instancesDirty(false),
+      contentRevision(0), boundsMin(0.0f), boundsMax(0.0f), visibleInstanceVBO(0), cullingEnabled(true), shadowInstanceVBO(0),
+      enabled(true), initialized(false),
+      citySeed(42), generation(0), streamingRadius(CHUNK_RADIUS),
+      centerChunkX(0), centerChunkZ(0), hasCenter(false)
 {
 }
 
@@ -18,12 +23,10 @@ City::~City()
     Cleanup();
 }
 
-void City::Initialize(unsigned int buildingShader)
+void City::Initialize()
 {
     if (initialized) return;
     
-    shaderProgram = buildingShader;
-    
     // Initialize building geometry (shared VAO)
     Building::InitializeGeometry();
     
@@ -33,8 +36,14 @@ void City::Initialize(unsigned int buildingShader)
     // Generate initial city
     Generate();
     
+    // Background generation for chunks streamed in around the camera.
+    // Started after the textures so workers only read immutable state.
+    streamer = std::make_unique<ChunkStreamer>(
+        [this](int chunkX, int chunkZ, int seed) { return GenerateChunk(chunkX, chunkZ, seed); });
+    
     initialized = true;
-    std::cout << "[City] Initialized with " << buildings.size() << " buildings" << std::endl;
+    std::cout << "[City] Initialized with " << instanceCount << " buildings" << std::endl;
+    std::cout << "[City] Frustum culling path: " << FrustumCuller::GetSimdPath() << std::endl;
 }
 
 void City::LoadBuildingTextures()
@@ -50,6 +59,9 @@ void City::LoadBuildingTextures()
     // Extensions to try
     const char* extensions[] = { ".jpg", ".png", ".jpeg" };
     
+    // Every facade becomes one layer of a single texture array
+    std::vector<FacadeImage> layers;
+    
     for (const char* facadeName : facadeNames)
     {
         for (const char* ext : extensions)
@@ -62,12 +74,10 @@ void City::LoadBuildingTextures()
             std::cout << "[City] Trying: " << relativePath << std::endl;
             std::cout << "[City]   Absolute: " << absPath << std::endl;
             
-            unsigned int texID = Building::LoadBuildingTexture(relativePath.c_str());
-            
-            // Check if texture loaded successfully (non-zero and not fallback white)
-            if (texID != 0)
+            FacadeImage image;
+            if (Building::LoadBuildingImage(relativePath.c_str(), image))
             {
-                buildingTextures.push_back(texID);
+                layers.push_back(std::move(image));
                 std::cout << "[City]   SUCCESS: Loaded " << relativePath << std::endl;
                 break; // Found this facade, move to next
             }
@@ -79,20 +89,20 @@ void City::LoadBuildingTextures()
     }
     
     // If no textures loaded, try default.png as final fallback
-    if (buildingTextures.empty())
+    if (layers.empty())
     {
         std::cout << "[City] WARNING: No facade textures found!" << std::endl;
         std::cout << "[City] Trying fallback: assets/textures/default.png" << std::endl;
         
-        unsigned int fallbackTex = Building::LoadBuildingTexture("assets/textures/default.png");
-        if (fallbackTex != 0)
+        FacadeImage fallback;
+        if (Building::LoadBuildingImage("assets/textures/default.png", fallback))
         {
-            buildingTextures.push_back(fallbackTex);
+            layers.push_back(std::move(fallback));
             std::cout << "[City] Using default.png as fallback" << std::endl;
         }
         else
         {
-            // Create procedural fallback
+            // Create procedural fallback (1x1 solid colours, one layer each)
             std::cout << "[City] Creating procedural fallback textures" << std::endl;
             
             unsigned char colors[][4] = {
@@ -103,45 +113,103 @@ void City::LoadBuildingTextures()
             
             for (auto& color : colors)
             {
-                unsigned int texID;
-                glGenTextures(1, &texID);
-                glBindTexture(GL_TEXTURE_2D, texID);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                buildingTextures.push_back(texID);
+                FacadeImage solid;
+                solid.width = 1;
+                solid.height = 1;
+                solid.pixels.assign(color, color + 4);
+                layers.push_back(std::move(solid));
             }
         }
     }
     
-    std::cout << "[City] Total facade textures loaded: " << buildingTextures.size() << std::endl;
+    facadeTextureArray = Building::CreateFacadeTextureArray(layers);
+    facadeLayerCount = facadeTextureArray != 0 ? static_cast<unsigned int>(layers.size()) : 0;
+    
+    std::cout << "[City] Total facade textures loaded: " << facadeLayerCount << std::endl;
 }
 
 void City::Generate(int seed)
 {
-    buildings.clear();
+    // Drop everything from the previous city, including in-flight jobs
+    chunks.clear();
+    pendingChunks.clear();
+    if (streamer)
+    {
+        streamer->CancelPending([](int, int) { return true; });
+    }
+    citySeed = seed;
+    generation++;
+    hasCenter = false;
     
     std::cout << "[City] ========================================" << std::endl;
     std::cout << "[City] Generating city with seed: " << seed << std::endl;
     std::cout << "[City] ========================================" << std::endl;
     
-    // Generate chunks around origin
-    for (int cx = -CHUNK_RADIUS; cx <= CHUNK_RADIUS; ++cx)
+    // Generate chunks around origin synchronously so the first frame has a city;
+    // UpdateChunks() streams the rest in around the camera
+    for (int cx = -streamingRadius; cx <= streamingRadius; ++cx)
     {
-        for (int cz = -CHUNK_RADIUS; cz <= CHUNK_RADIUS; ++cz)
+        for (int cz = -streamingRadius; cz <= streamingRadius; ++cz)
         {
-            GenerateChunk(cx, cz, seed);
+            IntegrateChunk({ cx, cz, generation, GenerateChunk(cx, cz, seed) });
         }
     }
     
+    UploadInstances();
+    
     std::cout << "[City] ========================================" << std::endl;
-    std::cout << "[City] Total buildings generated: " << buildings.size() << std::endl;
+    std::cout << "[City] Total buildings generated: " << instanceCount << std::endl;
     std::cout << "[City] City generation COMPLETE" << std::endl;
     std::cout << "[City] ========================================" << std::endl;
 }
 
-void City::GenerateChunk(int chunkX, int chunkZ, int baseSeed)
+void City::UploadInstances()
+{
+    size_t total = 0;
+    for (const auto& entry : chunks)
+    {
+        total += entry.second.instances.size();
+    }
+    
+    // Chunks cache their packed records, so this is a straight concatenation
+    std::vector<BuildingInstance> instances;
+    instances.reserve(total);
+    boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const auto& entry : chunks)
+    {
+        const CityChunk& chunk = entry.second;
+        instances.insert(instances.end(), chunk.instances.begin(), chunk.instances.end());
+        if (!chunk.instances.empty())
+        {
+            boundsMin = glm::min(boundsMin, chunk.boundsCenter - chunk.boundsExtent);
+            boundsMax = glm::max(boundsMax, chunk.boundsCenter + chunk.boundsExtent);
+        }
+    }
+    if (instances.empty())
+    {
+        boundsMin = boundsMax = glm::vec3(0.0f);
+    }
+    
+    if (instanceVBO == 0)
+    {
+        glGenBuffers(1, &instanceVBO);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // Re-specifying the store orphans the old one, so a streaming update never stalls on the GPU
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(BuildingInstance), instances.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    instanceCount = instances.size();
+    instancesDirty = false;
+    contentRevision++;
+}
+
+BuildingSoA City::GenerateChunk(int chunkX, int chunkZ, int baseSeed) const
 {
+    BuildingSoA buildings;
+    buildings.Reserve(GRID_SIZE * GRID_SIZE);
+    
     float chunkOffsetX = chunkX * GRID_SIZE * (BLOCK_SIZE + ROAD_WIDTH);
     float chunkOffsetZ = chunkZ * GRID_SIZE * (BLOCK_SIZE + ROAD_WIDTH);
     
@@ -158,7 +226,7 @@ void City::GenerateChunk(int chunkX, int chunkZ, int baseSeed)
             if (IsRoad(x, z)) continue;
             
             // Create unique seed for this building
-            int buildingSeed = baseSeed + (chunkX * 1000 + chunkZ) * 10000 + x * 100 + z;
+            uint32_t buildingSeed = BuildingSeed(baseSeed, chunkX, chunkZ, x, z);
             
             // Position with road gaps
             float posX = chunkOffsetX + x * (BLOCK_SIZE + ROAD_WIDTH);
@@ -169,8 +237,9 @@ void City::GenerateChunk(int chunkX, int chunkZ, int baseSeed)
             height = glm::clamp(height, 2.0f, 30.0f); // CLAMP: 2-30 units
             
             // Random width/depth variation with STRICT CLAMPING
-            float widthVar = 0.8f + ((buildingSeed % 20) / 100.0f);
-            float depthVar = 0.8f + (((buildingSeed / 7) % 20) / 100.0f);
+            // (separate bit ranges of the hash, so they do not follow the height)
+            float widthVar = 0.8f + (((buildingSeed >> 10) % 20u) / 100.0f);
+            float depthVar = 0.8f + (((buildingSeed >> 15) % 20u) / 100.0f);
             
             // CRITICAL: Clamp width/depth to prevent giant buildings
             widthVar = glm::clamp(widthVar, 0.8f, 1.0f);
@@ -201,21 +270,70 @@ void City::GenerateChunk(int chunkX, int chunkZ, int baseSeed)
             }
             
             // Random texture
-            unsigned int texID = GetRandomTexture(buildingSeed);
+            unsigned int texIndex = GetRandomTexture(buildingSeed);
             
-            buildings.emplace_back(position, scale, texID);
+            buildings.Push(position, scale, static_cast<float>(texIndex));
             buildingCount++;
         }
     }
     
-    // Log chunk statistics
+    // Log chunk statistics (one write, since this runs on worker threads)
     if (buildingCount > 0)
     {
-        std::cout << "[City] Chunk (" << chunkX << "," << chunkZ << ") generated: " 
-                  << buildingCount << " buildings" << std::endl;
-        std::cout << "[City]   Height range: " << minHeight << " - " << maxHeight << std::endl;
-        std::cout << "[City]   Width range: " << minWidth << " - " << maxWidth << std::endl;
+        std::ostringstream log;
+        log << "[City] Chunk (" << chunkX << "," << chunkZ << ") generated: " 
+            << buildingCount << " buildings\n";
+        log << "[City]   Height range: " << minHeight << " - " << maxHeight << "\n";
+        log << "[City]   Width range: " << minWidth << " - " << maxWidth << "\n";
+        std::cout << log.str() << std::flush;
     }
+    
+    return buildings;
+}
+
+void City::IntegrateChunk(CompletedChunk&& completed)
+{
+    // Stale (previous city): the key may already be pending again for this one
+    if (completed.generation != generation) return;
+    
+    long long key = ChunkKey(completed.chunkX, completed.chunkZ);
+    pendingChunks.erase(key);
+    
+    // Already resident
+    if (chunks.count(key) != 0) return;
+    
+    CityChunk chunk;
+    chunk.chunkX = completed.chunkX;
+    chunk.chunkZ = completed.chunkZ;
+    chunk.buildings = std::move(completed.buildings);
+    
+    // Instance records and bounds are built once here; frames only copy or cull them
+    const BuildingSoA& soa = chunk.buildings;
+    const size_t count = soa.Size();
+    chunk.instances.resize(count);
+    Building::PackInstances(soa, chunk.instances.data());
+    
+    glm::vec3 chunkMin(std::numeric_limits<float>::max());
+    glm::vec3 chunkMax(std::numeric_limits<float>::lowest());
+    chunk.bounds.Reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Unit cube is centred on position, so the half extent is scale / 2
+        glm::vec3 position(soa.px[i], soa.py[i], soa.pz[i]);
+        glm::vec3 extent = glm::vec3(soa.sx[i], soa.sy[i], soa.sz[i]) * 0.5f;
+        chunk.bounds.Push(position, extent);
+        chunkMin = glm::min(chunkMin, position - extent);
+        chunkMax = glm::max(chunkMax, position + extent);
+    }
+    if (count == 0)
+    {
+        chunkMin = chunkMax = glm::vec3(0.0f);
+    }
+    chunk.boundsCenter = (chunkMin + chunkMax) * 0.5f;
+    chunk.boundsExtent = (chunkMax - chunkMin) * 0.5f;
+    
+    chunks[key] = std::move(chunk);
+    instancesDirty = true;
 }
 
 bool City::IsRoad(int x, int z) const
@@ -224,121 +342,325 @@ bool City::IsRoad(int x, int z) const
     return (x % 4 == 0) || (z % 4 == 0);
 }
 
-float City::GetRandomHeight(int seed) const
+float City::GetRandomHeight(uint32_t seed) const
 {
     // Deterministic pseudo-random height
-    float t = (seed % 1000) / 1000.0f;
+    float t = (seed % 1000u) / 1000.0f;
     return MIN_HEIGHT + t * (MAX_HEIGHT - MIN_HEIGHT);
 }
 
-unsigned int City::GetRandomTexture(int seed) const
+unsigned int City::GetRandomTexture(uint32_t seed) const
+{
+    if (facadeLayerCount == 0) return 0;
+    // Upper bits: the lower ones already pick the height, width and depth
+    return (seed >> 20) % facadeLayerCount;
+}
+
+long long City::ChunkKey(int chunkX, int chunkZ)
 {
-    if (buildingTextures.empty()) return 0;
-    int index = seed % buildingTextures.size();
-    return buildingTextures[index];
+    // Shift in unsigned arithmetic; left-shifting a negative value is undefined
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkZ);
+    return static_cast<long long>(key);
+}
+
+uint32_t City::BuildingSeed(int baseSeed, int chunkX, int chunkZ, int x, int z)
+{
+    // Unsigned throughout, so no chunk coordinate can overflow, and every
+    // (chunk, x, z) hashes distinct input bytes instead of a packed sum
+    uint64_t words[] = {
+        static_cast<uint32_t>(baseSeed),
+        static_cast<uint64_t>(ChunkKey(chunkX, chunkZ)),
+        static_cast<uint32_t>(x),
+        static_cast<uint32_t>(z)
+    };
+    uint64_t h = 14695981039346656037ull;
+    for (uint64_t word : words)
+    {
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            h ^= (word >> (byte * 8)) & 0xffu;
+            h *= 1099511628211ull;
+        }
+    }
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+int City::ChunkDistance(int chunkX, int chunkZ) const
+{
+    // Chebyshev distance: the streamed region is a square of chunks
+    return glm::max(std::abs(chunkX - centerChunkX), std::abs(chunkZ - centerChunkZ));
+}
+
+void City::SetStreamingRadius(int radius)
+{
+    streamingRadius = glm::max(radius, 0);
+    hasCenter = false;  // Re-evaluate the streamed region on the next update
 }
 
 void City::UpdateChunks(const glm::vec3& cameraPos)
 {
+    if (!initialized || !streamer) return;
+    
     // Calculate which chunk the camera is in
     float chunkSize = GRID_SIZE * (BLOCK_SIZE + ROAD_WIDTH);
     int camChunkX = static_cast<int>(std::floor(cameraPos.x / chunkSize));
     int camChunkZ = static_cast<int>(std::floor(cameraPos.z / chunkSize));
     
-    // For now, keep all buildings (optimization can be added later)
-    // In a full implementation, you'd dynamically load/unload chunks here
+    const int evictRadius = streamingRadius + EVICT_MARGIN;
+    
+    // Only touch the streamed region when the camera enters a new chunk
+    if (!hasCenter || camChunkX != centerChunkX || camChunkZ != centerChunkZ)
+    {
+        centerChunkX = camChunkX;
+        centerChunkZ = camChunkZ;
+        hasCenter = true;
+        
+        // Evict chunks outside the hysteresis radius
+        for (auto it = chunks.begin(); it != chunks.end(); )
+        {
+            if (ChunkDistance(it->second.chunkX, it->second.chunkZ) > evictRadius)
+            {
+                it = chunks.erase(it);
+                instancesDirty = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        
+        // Queued jobs that drifted out of range are no longer worth generating
+        streamer->CancelPending([&](int chunkX, int chunkZ) {
+            bool cancel = ChunkDistance(chunkX, chunkZ) > evictRadius;
+            if (cancel) pendingChunks.erase(ChunkKey(chunkX, chunkZ));
+            return cancel;
+        });
+        
+        // Request missing chunks inside the radius, nearest first
+        std::vector<std::pair<int, int>> missing;
+        for (int cx = camChunkX - streamingRadius; cx <= camChunkX + streamingRadius; ++cx)
+        {
+            for (int cz = camChunkZ - streamingRadius; cz <= camChunkZ + streamingRadius; ++cz)
+            {
+                long long key = ChunkKey(cx, cz);
+                if (chunks.count(key) == 0 && pendingChunks.count(key) == 0)
+                {
+                    missing.emplace_back(cx, cz);
+                }
+            }
+        }
+        std::sort(missing.begin(), missing.end(), [&](const auto& a, const auto& b) {
+            int da = (a.first - camChunkX) * (a.first - camChunkX) + (a.second - camChunkZ) * (a.second - camChunkZ);
+            int db = (b.first - camChunkX) * (b.first - camChunkX) + (b.second - camChunkZ) * (b.second - camChunkZ);
+            return da < db;
+        });
+        for (const auto& chunk : missing)
+        {
+            pendingChunks.insert(ChunkKey(chunk.first, chunk.second));
+            streamer->Request(chunk.first, chunk.second, citySeed, generation);
+        }
+    }
+    
+    // Integrate a bounded number of finished chunks per frame to keep frame time flat
+    std::vector<CompletedChunk> completed;
+    streamer->PollCompleted(completed, MAX_CHUNKS_PER_FRAME);
+    for (auto& chunk : completed)
+    {
+        // Stale completions fall through to IntegrateChunk, which drops them
+        if (chunk.generation == generation && ChunkDistance(chunk.chunkX, chunk.chunkZ) > evictRadius)
+        {
+            pendingChunks.erase(ChunkKey(chunk.chunkX, chunk.chunkZ));
+            continue;
+        }
+        IntegrateChunk(std::move(chunk));
+    }
+    
+    if (instancesDirty)
+    {
+        UploadInstances();
+    }
+}
+
+void City::Render(const glm::mat4& view, const glm::mat4& projection, const Shader& buildingShader)
+{
+    if (!enabled || !initialized || instanceCount == 0) return;
+    
+    if (!cullingEnabled)
+    {
+        cullStats = CityCullStats();
+        cullStats.buildingsVisible = instanceCount;
+    }
+    else
+    {
+        FrustumPlanes frustum = Camera::ExtractFrustumPlanes(projection * view);
+        CullInstances(frustum.planes, 6, visibleInstances, cullStats);
+        if (!visibleInstances.empty())
+        {
+            StreamInstances(visibleInstanceVBO, visibleInstances);
+        }
+    }
+    
+    RenderVisible(buildingShader);
 }
 
-void City::Render(const glm::mat4& view, const glm::mat4& projection, 
-                  const glm::mat4& lightSpaceMatrix, const glm::vec3& cameraPos)
+void City::RenderVisible(const Shader& buildingShader)
 {
-    if (!enabled || !initialized || buildings.empty()) return;
+    if (!enabled || !initialized || instanceCount == 0) return;
+    if (cullingEnabled && visibleInstances.empty()) return;
     
-    glUseProgram(shaderProgram);
+    // Facade array sampler is fixed to unit 0 when the variant is linked
+    buildingShader.Use();
     
-    // Set matrices
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+    // CRITICAL: Bind the facade array once - instances pick their layer in the shader
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, facadeTextureArray);
     
-    // Render each building
-    for (const auto& building : buildings)
+    if (!cullingEnabled)
     {
-        // Set model matrix
-        glm::mat4 model = building.GetModelMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        
-        // FIXED: Pass building scale for UV tiling (prevents stretching)
-        glUniform3fv(glGetUniformLocation(shaderProgram, "buildingScale"), 1, glm::value_ptr(building.scale));
+        // Whole city in a single instanced draw
+        Building::RenderInstanced(instanceVBO, 0, instanceCount);
+        return;
+    }
+    
+    // Visible buildings in a single instanced draw
+    Building::RenderInstanced(visibleInstanceVBO, 0, visibleInstances.size());
+}
+
+void City::StreamInstances(unsigned int& vbo, const std::vector<BuildingInstance>& instances)
+{
+    if (vbo == 0)
+    {
+        glGenBuffers(1, &vbo);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // Orphan and refill every frame; the previous frame's store may still be in flight
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(BuildingInstance), 
+                 instances.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void City::CullInstances(const glm::vec4* planes, int planeCount, 
+                         std::vector<BuildingInstance>& out, CityCullStats& stats)
+{
+    stats = CityCullStats();
+    out.clear();
+    
+    for (const auto& entry : chunks)
+    {
+        const CityChunk& chunk = entry.second;
+        const size_t count = chunk.instances.size();
+        stats.chunksTested++;
         
-        // CRITICAL: Bind building texture to correct unit
-        glActiveTexture(GL_TEXTURE0);
+        // Coarse test: whole chunks in or out skip the per-building pass
+        FrustumCuller::Containment containment = 
+            FrustumCuller::TestAABB(planes, planeCount, chunk.boundsCenter, chunk.boundsExtent);
         
-        // Use valid texture or fallback to white
-        if (building.textureID != 0)
+        if (containment == FrustumCuller::Containment::Outside)
         {
-            glBindTexture(GL_TEXTURE_2D, building.textureID);
+            stats.chunksCulled++;
+            stats.buildingsCulled += count;
+            continue;
         }
-        else
+        
+        if (containment == FrustumCuller::Containment::Inside)
         {
-            // If texture is 0, create a simple white texture as fallback
-            static unsigned int whiteTex = 0;
-            if (whiteTex == 0)
-            {
-                unsigned char white[4] = {255, 255, 255, 255};
-                glGenTextures(1, &whiteTex);
-                glBindTexture(GL_TEXTURE_2D, whiteTex);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            }
-            else
-            {
-                glBindTexture(GL_TEXTURE_2D, whiteTex);
-            }
+            out.insert(out.end(), chunk.instances.begin(), chunk.instances.end());
+            continue;
         }
         
-        glUniform1i(glGetUniformLocation(shaderProgram, "buildingTexture"), 0);
+        // Straddling chunk: test every building, then compact the survivors
+        if (visibleIndices.size() < count)
+        {
+            visibleIndices.resize(count);
+        }
+        size_t visible = FrustumCuller::CullAABBs(planes, planeCount, chunk.bounds, visibleIndices.data());
+        for (size_t i = 0; i < visible; ++i)
+        {
+            out.push_back(chunk.instances[visibleIndices[i]]);
+        }
         
-        // Render cube geometry
-        Building::RenderGeometry();
+        stats.buildingsTested += count;
+        stats.buildingsCulled += count - visible;
     }
+    
+    stats.buildingsVisible = out.size();
 }
 
-void City::RenderShadow(const glm::mat4& lightSpaceMatrix, unsigned int shadowShader)
+void City::RenderShadow(const glm::mat4& lightSpaceMatrix, const Shader& shadowShader)
 {
-    if (!enabled || !initialized || buildings.empty()) return;
-    
-    glUseProgram(shadowShader);
+    if (!enabled || !initialized || instanceCount == 0) return;
     
-    // Set light space matrix
-    glUniformMatrix4fv(glGetUniformLocation(shadowShader, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+    // shadowShader must be the instanced variant (building_shadow.vert)
+    shadowShader.Use();
+    shadowShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
     
-    // Render each building for shadow casting
-    for (const auto& building : buildings)
+    if (!cullingEnabled)
     {
-        // Set model matrix
-        glm::mat4 model = building.GetModelMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(shadowShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
+        shadowCullStats = CityCullStats();
+        shadowCullStats.buildingsVisible = instanceCount;
         
-        // Render geometry (no texture needed for shadow pass)
-        Building::RenderGeometry();
+        // Texture is irrelevant for depth, so the whole city is a single draw
+        Building::RenderInstanced(instanceVBO, 0, instanceCount);
+        return;
     }
+    
+    // Cull casters against the light's ortho volume, minus its near plane:
+    // the volume is extruded back toward the light so buildings behind the
+    // near plane that still shade visible receivers are kept
+    FrustumPlanes lightFrustum = Camera::ExtractFrustumPlanes(lightSpaceMatrix);
+    const glm::vec4 casterPlanes[5] = {
+        lightFrustum.planes[0], lightFrustum.planes[1],
+        lightFrustum.planes[2], lightFrustum.planes[3],
+        lightFrustum.planes[5]
+    };
+    CullInstances(casterPlanes, 5, shadowInstances, shadowCullStats);
+    if (shadowInstances.empty()) return;
+    
+    StreamInstances(shadowInstanceVBO, shadowInstances);
+    
+    // Depth clamp flattens the extruded casters onto the near plane instead of clipping them
+    GLState::Enable(GL_DEPTH_CLAMP);
+    Building::RenderInstanced(shadowInstanceVBO, 0, shadowInstances.size());
+    GLState::Disable(GL_DEPTH_CLAMP);
 }
 
 void City::Cleanup()
 {
     if (initialized)
     {
+        // Join worker threads before tearing down anything they might read
+        streamer.reset();
+        
         Building::CleanupGeometry();
         
         // Delete building textures
-        for (unsigned int texID : buildingTextures)
+        if (facadeTextureArray != 0)
+        {
+            GLState::DeleteTextures(1, &facadeTextureArray);
+            facadeTextureArray = 0;
+        }
+        facadeLayerCount = 0;
+        chunks.clear();
+        pendingChunks.clear();
+        instanceCount = 0;
+        
+        if (instanceVBO != 0)
+        {
+            glDeleteBuffers(1, &instanceVBO);
+            instanceVBO = 0;
+        }
+        if (visibleInstanceVBO != 0)
+        {
+            glDeleteBuffers(1, &visibleInstanceVBO);
+            visibleInstanceVBO = 0;
+        }
+        visibleInstances.clear();
+        if (shadowInstanceVBO != 0)
         {
-            glDeleteTextures(1, &texID);
+            glDeleteBuffers(1, &shadowInstanceVBO);
+            shadowInstanceVBO = 0;
         }
-        buildingTextures.clear();
-        buildings.clear();
+        shadowInstances.clear();
         
         initialized = false;
     }
@@ -0,0 +1,158 @@
+#include "FrameGovernor.h"
+#include <iostream>
+
+namespace
+{
+    // Drop a level when the window average exceeds the target by this fraction
+    const double DOWNGRADE_MARGIN = 0.10;
+    // Raise a level only when the average is below this fraction of the target
+    const double UPGRADE_RATIO = 0.70;
+}
+
+// Level 0 places no cap on the PCF kernel (49 covers the legacy loop)
+const QualityLevel FrameGovernor::LEVELS[LEVEL_COUNT] = {
+    { 1.00f, 49, 6, 0, "Full" },
+    { 1.00f,  9, 5, 0, "High" },
+    { 0.85f,  9, 5, 0, "Medium" },
+    { 0.75f,  4, 4, 1, "Low" },
+    { 0.67f,  4, 4, 1, "Lower" },
+    { 0.50f,  1, 3, 1, "Lowest" }
+};
+
+FrameGovernor::FrameGovernor()
+    : current(0), initialized(false), enabled(false), targetMs(16.7), level(0),
+      lastMs(0.0), windowTotalMs(0.0), windowSamples(0), windowAverageMs(0.0), fastWindows(0)
+{
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        queries[i * 2] = queries[i * 2 + 1] = 0;
+        pending[i] = false;
+        discard[i] = false;
+    }
+}
+
+FrameGovernor::~FrameGovernor()
+{
+    Cleanup();
+}
+
+void FrameGovernor::Initialize()
+{
+    if (initialized) return;
+
+    glGenQueries(QUERY_COUNT * 2, queries);
+    initialized = true;
+}
+
+void FrameGovernor::Cleanup()
+{
+    if (!initialized) return;
+
+    glDeleteQueries(QUERY_COUNT * 2, queries);
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        queries[i * 2] = queries[i * 2 + 1] = 0;
+        pending[i] = false;
+        discard[i] = false;
+    }
+    initialized = false;
+}
+
+void FrameGovernor::BeginFrame()
+{
+    if (!initialized) return;
+
+    // The pair was issued QUERY_COUNT frames ago; its result is normally ready
+    if (pending[current])
+    {
+        Collect(current);
+    }
+    glQueryCounter(queries[current * 2], GL_TIMESTAMP);
+}
+
+void FrameGovernor::EndFrame()
+{
+    if (!initialized) return;
+
+    glQueryCounter(queries[current * 2 + 1], GL_TIMESTAMP);
+    pending[current] = true;
+    current = (current + 1) % QUERY_COUNT;
+}
+
+void FrameGovernor::SetEnabled(bool enable)
+{
+    if (enable == enabled) return;
+
+    enabled = enable;
+    // Frames in flight were rendered at the other settings
+    ChangeLevel(level);
+}
+
+void FrameGovernor::Collect(int index)
+{
+    GLuint64 beginNs = 0;
+    GLuint64 endNs = 0;
+    glGetQueryObjectui64v(queries[index * 2], GL_QUERY_RESULT, &beginNs);
+    glGetQueryObjectui64v(queries[index * 2 + 1], GL_QUERY_RESULT, &endNs);
+    pending[index] = false;
+    if (discard[index])
+    {
+        discard[index] = false;
+        return;
+    }
+
+    lastMs = static_cast<double>(endNs - beginNs) / 1.0e6;
+    windowTotalMs += lastMs;
+    windowSamples++;
+    if (windowSamples >= WINDOW_FRAMES)
+    {
+        Evaluate();
+    }
+}
+
+void FrameGovernor::Evaluate()
+{
+    windowAverageMs = windowTotalMs / windowSamples;
+    windowTotalMs = 0.0;
+    windowSamples = 0;
+    if (!enabled) return;
+
+    if (windowAverageMs > targetMs * (1.0 + DOWNGRADE_MARGIN))
+    {
+        fastWindows = 0;
+        if (level < LEVEL_COUNT - 1)
+        {
+            ChangeLevel(level + 1);
+        }
+    }
+    else if (windowAverageMs < targetMs * UPGRADE_RATIO && level > 0)
+    {
+        if (++fastWindows >= UPGRADE_WINDOWS)
+        {
+            ChangeLevel(level - 1);
+        }
+    }
+    else
+    {
+        fastWindows = 0;
+    }
+}
+
+void FrameGovernor::ChangeLevel(int newLevel)
+{
+    if (newLevel != level)
+    {
+        std::cout << "[Governor] " << windowAverageMs << " ms vs " << targetMs << " ms target: "
+                  << LEVELS[level].name << " -> " << LEVELS[newLevel].name << std::endl;
+    }
+    level = newLevel;
+
+    // Start a fresh window and drop frames still in flight at the old settings
+    windowTotalMs = 0.0;
+    windowSamples = 0;
+    fastWindows = 0;
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        discard[i] = pending[i];
+    }
+}
@@ -0,0 +1,178 @@
+#include "FrameGraph.h"
+#include "GLState.h"
+#include <algorithm>
+#include <iostream>
+
+FrameGraph::FrameGraph()
+    : stats{}, lastReported{}
+{
+}
+
+void FrameGraph::Reset()
+{
+    // clear() keeps the capacity, so a steady frame does not reallocate the lists
+    resources.clear();
+    passes.clear();
+}
+
+FrameGraph::ResourceId FrameGraph::CreateTarget(const char* name, const RenderTargetDesc& desc)
+{
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.imported = false;
+    resource.texture = resource.fbo = 0;
+    resource.width = desc.width;
+    resource.height = desc.height;
+    resource.output = false;
+    resource.firstPass = resource.lastPass = -1;
+    resource.poolIndex = -1;
+    resources.push_back(resource);
+    return static_cast<ResourceId>(resources.size() - 1);
+}
+
+FrameGraph::ResourceId FrameGraph::Import(const char* name, unsigned int texture, unsigned int fbo,
+                                          unsigned int width, unsigned int height)
+{
+    ResourceId id = CreateTarget(name, RenderTargetDesc{ width, height, GL_NONE });
+    resources[id].imported = true;
+    resources[id].texture = texture;
+    resources[id].fbo = fbo;
+    return id;
+}
+
+int FrameGraph::AddPass(const char* name, std::vector<ResourceId> inputs, std::vector<ResourceId> outputs, PassFn execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.inputs = std::move(inputs);
+    pass.outputs = std::move(outputs);
+    pass.execute = std::move(execute);
+    pass.active = false;
+    passes.push_back(std::move(pass));
+    return static_cast<int>(passes.size() - 1);
+}
+
+void FrameGraph::MarkOutput(ResourceId resource)
+{
+    resources[resource].output = true;
+}
+
+void FrameGraph::Compile()
+{
+    // Culling: backwards from the outputs, a pass is needed if anything
+    // needed is written by it, and then everything it reads is needed too
+    std::vector<bool> needed(resources.size(), false);
+    for (size_t i = 0; i < resources.size(); ++i)
+    {
+        needed[i] = resources[i].output;
+    }
+    for (int p = static_cast<int>(passes.size()) - 1; p >= 0; --p)
+    {
+        Pass& pass = passes[p];
+        pass.active = std::any_of(pass.outputs.begin(), pass.outputs.end(),
+                                  [&needed](ResourceId id) { return needed[id]; });
+        if (!pass.active) continue;
+        for (ResourceId id : pass.inputs)
+        {
+            needed[id] = true;
+        }
+    }
+
+    // Lifetimes over the surviving passes
+    for (int p = 0; p < static_cast<int>(passes.size()); ++p)
+    {
+        if (!passes[p].active) continue;
+        for (const std::vector<ResourceId>* list : { &passes[p].inputs, &passes[p].outputs })
+        {
+            for (ResourceId id : *list)
+            {
+                if (resources[id].firstPass < 0) resources[id].firstPass = p;
+                resources[id].lastPass = p;
+            }
+        }
+    }
+
+    // Aliasing: acquire at first use, release after last use. A pass's own
+    // inputs and outputs are all acquired before any of them is released
+    stats = Stats{};
+    stats.passCount = static_cast<int>(passes.size());
+    std::vector<int> physical;
+    for (int p = 0; p < static_cast<int>(passes.size()); ++p)
+    {
+        if (!passes[p].active)
+        {
+            stats.culledPasses++;
+            continue;
+        }
+        for (const std::vector<ResourceId>* list : { &passes[p].inputs, &passes[p].outputs })
+        {
+            for (ResourceId id : *list)
+            {
+                Resource& resource = resources[id];
+                if (resource.imported || resource.poolIndex >= 0) continue;
+
+                resource.poolIndex = pool.Acquire(resource.desc);
+                size_t bytes = static_cast<size_t>(resource.width) * resource.height *
+                               RenderTargetPool::BytesPerPixel(resource.desc.internalFormat);
+                stats.transientTargets++;
+                stats.transientBytes += bytes;
+                if (std::find(physical.begin(), physical.end(), resource.poolIndex) == physical.end())
+                {
+                    physical.push_back(resource.poolIndex);
+                    stats.physicalBytes += bytes;
+                }
+            }
+        }
+        for (Resource& resource : resources)
+        {
+            if (!resource.imported && resource.lastPass == p)
+            {
+                pool.Release(resource.poolIndex);
+            }
+        }
+    }
+    stats.physicalTargets = static_cast<int>(physical.size());
+
+    // Report when the shape of the frame changes (mode switch, resize, culling)
+    if (stats.passCount != lastReported.passCount || stats.culledPasses != lastReported.culledPasses ||
+        stats.transientBytes != lastReported.transientBytes || stats.physicalBytes != lastReported.physicalBytes)
+    {
+        std::cout << "[FrameGraph] " << stats.passCount - stats.culledPasses << "/" << stats.passCount << " passes ("
+                  << stats.culledPasses << " culled), " << stats.transientTargets << " targets in "
+                  << stats.physicalTargets << " textures: " << stats.transientBytes / (1024.0 * 1024.0) << " MB -> "
+                  << stats.physicalBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+        lastReported = stats;
+    }
+}
+
+void FrameGraph::Execute()
+{
+    for (Pass& pass : passes)
+    {
+        if (pass.active)
+        {
+            pass.execute(*this);
+        }
+    }
+    pool.EndFrame();
+}
+
+unsigned int FrameGraph::GetTexture(ResourceId resource) const
+{
+    const Resource& r = resources[resource];
+    return r.imported ? r.texture : pool.Get(r.poolIndex).texture;
+}
+
+void FrameGraph::BindOutput(ResourceId resource) const
+{
+    const Resource& r = resources[resource];
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, r.imported ? r.fbo : pool.Get(r.poolIndex).fbo);
+    GLState::Viewport(0, 0, r.width, r.height);
+}
+
+void FrameGraph::Cleanup()
+{
+    Reset();
+    pool.Clear();
+}
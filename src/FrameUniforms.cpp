@@ -0,0 +1,46 @@
+#include "FrameUniforms.h"
+#include "Shader.h"
+#include <iostream>
+
+FrameUniforms::FrameUniforms()
+    : ubo(0)
+{
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    Cleanup();
+}
+
+void FrameUniforms::Initialize()
+{
+    if (ubo != 0) return;
+
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo);
+
+    // Programs linked from now on attach their FrameData block automatically
+    Shader::SetUniformBlockBinding("FrameData", BINDING);
+
+    std::cout << "[FrameUniforms] FrameData UBO (" << sizeof(FrameData) << " bytes) at binding " << BINDING << std::endl;
+}
+
+void FrameUniforms::Update(const FrameData& data)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    // Re-specifying the store orphans last frame's copy instead of waiting on it
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::Cleanup()
+{
+    if (ubo != 0)
+    {
+        glDeleteBuffers(1, &ubo);
+        ubo = 0;
+    }
+}
@@ -0,0 +1,142 @@
+#include "FrustumCuller.h"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_CULLER_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_CULLER_SSE 1
+#endif
+
+void BoundsSoA::Clear()
+{
+    centerX.clear(); centerY.clear(); centerZ.clear();
+    extentX.clear(); extentY.clear(); extentZ.clear();
+}
+
+void BoundsSoA::Reserve(size_t count)
+{
+    centerX.reserve(count); centerY.reserve(count); centerZ.reserve(count);
+    extentX.reserve(count); extentY.reserve(count); extentZ.reserve(count);
+}
+
+void BoundsSoA::Push(const glm::vec3& center, const glm::vec3& extent)
+{
+    centerX.push_back(center.x); centerY.push_back(center.y); centerZ.push_back(center.z);
+    extentX.push_back(extent.x); extentY.push_back(extent.y); extentZ.push_back(extent.z);
+}
+
+FrustumCuller::Containment FrustumCuller::TestAABB(const glm::vec4* planes, int planeCount,
+                                                   const glm::vec3& center, const glm::vec3& extent)
+{
+    Containment result = Containment::Inside;
+    for (int p = 0; p < planeCount; ++p)
+    {
+        const glm::vec4& plane = planes[p];
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+
+        if (distance + radius < 0.0f)
+            return Containment::Outside;
+        if (distance - radius < 0.0f)
+            result = Containment::Intersecting;
+    }
+    return result;
+}
+
+size_t FrustumCuller::CullAABBs(const glm::vec4* planes, int planeCount,
+                                const BoundsSoA& boxes, uint32_t* outIndices)
+{
+    const size_t count = boxes.Size();
+    const float* cx = boxes.centerX.data();
+    const float* cy = boxes.centerY.data();
+    const float* cz = boxes.centerZ.data();
+    const float* ex = boxes.extentX.data();
+    const float* ey = boxes.extentY.data();
+    const float* ez = boxes.extentZ.data();
+
+    size_t visible = 0;
+    size_t i = 0;
+
+#if defined(FRUSTUM_CULLER_AVX)
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 bx = _mm256_loadu_ps(cx + i), by = _mm256_loadu_ps(cy + i), bz = _mm256_loadu_ps(cz + i);
+        __m256 hx = _mm256_loadu_ps(ex + i), hy = _mm256_loadu_ps(ey + i), hz = _mm256_loadu_ps(ez + i);
+        __m256 outside = zero;
+
+        for (int p = 0; p < planeCount; ++p)
+        {
+            const glm::vec4& plane = planes[p];
+            __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), bx), _mm256_mul_ps(_mm256_set1_ps(plane.y), by)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), bz), _mm256_set1_ps(plane.w)));
+            __m256 radius = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)), hx), _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), hy)),
+                _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), hz));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+        }
+
+        // Branch-free compaction of the surviving lanes
+        int mask = ~_mm256_movemask_ps(outside) & 0xFF;
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            outIndices[visible] = static_cast<uint32_t>(i + lane);
+            visible += (mask >> lane) & 1;
+        }
+    }
+#elif defined(FRUSTUM_CULLER_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 bx = _mm_loadu_ps(cx + i), by = _mm_loadu_ps(cy + i), bz = _mm_loadu_ps(cz + i);
+        __m128 hx = _mm_loadu_ps(ex + i), hy = _mm_loadu_ps(ey + i), hz = _mm_loadu_ps(ez + i);
+        __m128 outside = zero;
+
+        for (int p = 0; p < planeCount; ++p)
+        {
+            const glm::vec4& plane = planes[p];
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), bx), _mm_mul_ps(_mm_set1_ps(plane.y), by)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), bz), _mm_set1_ps(plane.w)));
+            __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), hx), _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), hy)),
+                _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), hz));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        // Branch-free compaction of the surviving lanes
+        int mask = ~_mm_movemask_ps(outside) & 0xF;
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            outIndices[visible] = static_cast<uint32_t>(i + lane);
+            visible += (mask >> lane) & 1;
+        }
+    }
+#endif
+
+    // Remainder (and the whole range on non-SIMD targets)
+    for (; i < count; ++i)
+    {
+        if (TestAABB(planes, planeCount, glm::vec3(cx[i], cy[i], cz[i]),
+                     glm::vec3(ex[i], ey[i], ez[i])) != Containment::Outside)
+        {
+            outIndices[visible++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    return visible;
+}
+
+const char* FrustumCuller::GetSimdPath()
+{
+#if defined(FRUSTUM_CULLER_AVX)
+    return "AVX";
+#elif defined(FRUSTUM_CULLER_SSE)
+    return "SSE";
+#else
+    return "Scalar";
+#endif
+}
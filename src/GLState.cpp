@@ -0,0 +1,301 @@
+#include "GLState.h"
+
+GLuint GLState::program = GLState::UNKNOWN;
+GLuint GLState::vertexArray = GLState::UNKNOWN;
+GLuint GLState::activeUnit = GLState::UNKNOWN;
+GLuint GLState::textures[GLState::MAX_TEXTURE_UNITS][GLState::TARGET_COUNT];
+GLuint GLState::samplers[GLState::MAX_TEXTURE_UNITS];
+GLuint GLState::drawFramebuffer = GLState::UNKNOWN;
+GLuint GLState::readFramebuffer = GLState::UNKNOWN;
+GLint GLState::viewport[4] = { -1, -1, -1, -1 };
+int GLState::capabilities[GLState::CAP_COUNT] = { -1, -1, -1, -1 };
+GLenum GLState::blendSource = GLState::UNKNOWN;
+GLenum GLState::blendDest = GLState::UNKNOWN;
+GLenum GLState::depthFunc = GLState::UNKNOWN;
+int GLState::depthMask = -1;
+GLenum GLState::cullFace = GLState::UNKNOWN;
+GLStateStats GLState::stats;
+
+void GLState::Invalidate()
+{
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (auto& unit : textures)
+    {
+        for (GLuint& texture : unit)
+        {
+            texture = UNKNOWN;
+        }
+    }
+    for (GLuint& sampler : samplers)
+    {
+        sampler = UNKNOWN;
+    }
+    drawFramebuffer = UNKNOWN;
+    readFramebuffer = UNKNOWN;
+    viewport[0] = viewport[1] = viewport[2] = viewport[3] = -1;
+    for (int& capability : capabilities)
+    {
+        capability = -1;
+    }
+    blendSource = blendDest = UNKNOWN;
+    depthFunc = UNKNOWN;
+    depthMask = -1;
+    cullFace = UNKNOWN;
+}
+
+int GLState::TargetIndex(GLenum target)
+{
+    switch (target)
+    {
+        case GL_TEXTURE_2D:       return TARGET_2D;
+        case GL_TEXTURE_2D_ARRAY: return TARGET_2D_ARRAY;
+        case GL_TEXTURE_CUBE_MAP: return TARGET_CUBE_MAP;
+        default:                  return -1;
+    }
+}
+
+int GLState::CapabilityIndex(GLenum capability)
+{
+    switch (capability)
+    {
+        case GL_DEPTH_TEST:  return CAP_DEPTH_TEST;
+        case GL_BLEND:       return CAP_BLEND;
+        case GL_CULL_FACE:   return CAP_CULL_FACE;
+        case GL_DEPTH_CLAMP: return CAP_DEPTH_CLAMP;
+        default:             return -1;
+    }
+}
+
+void GLState::UseProgram(GLuint id)
+{
+    if (Update(program, id))
+    {
+        glUseProgram(id);
+    }
+}
+
+void GLState::BindVertexArray(GLuint vao)
+{
+    if (Update(vertexArray, vao))
+    {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLState::ActiveTexture(GLenum unit)
+{
+    if (Update(activeUnit, static_cast<GLuint>(unit - GL_TEXTURE0)))
+    {
+        glActiveTexture(unit);
+    }
+}
+
+void GLState::BindTexture(GLenum target, GLuint texture)
+{
+    int targetIndex = TargetIndex(target);
+    if (targetIndex < 0 || activeUnit >= static_cast<GLuint>(MAX_TEXTURE_UNITS))
+    {
+        // Untracked target, or unit not known yet: always issue
+        stats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (Update(textures[activeUnit][targetIndex], texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
+
+void GLState::BindSampler(GLuint unit, GLuint sampler)
+{
+    if (unit >= static_cast<GLuint>(MAX_TEXTURE_UNITS))
+    {
+        stats.issued++;
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+    if (Update(samplers[unit], sampler))
+    {
+        glBindSampler(unit, sampler);
+    }
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool changed = false;
+    if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER)
+    {
+        changed |= drawFramebuffer != framebuffer;
+        drawFramebuffer = framebuffer;
+    }
+    if (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER)
+    {
+        changed |= readFramebuffer != framebuffer;
+        readFramebuffer = framebuffer;
+    }
+
+    if (changed)
+    {
+        stats.issued++;
+        glBindFramebuffer(target, framebuffer);
+    }
+    else
+    {
+        stats.skipped++;
+    }
+}
+
+GLuint GLState::GetDrawFramebuffer()
+{
+    if (drawFramebuffer == UNKNOWN)
+    {
+        GLint current = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &current);
+        drawFramebuffer = static_cast<GLuint>(current);
+    }
+    return drawFramebuffer;
+}
+
+void GLState::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+    {
+        stats.skipped++;
+        return;
+    }
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+    stats.issued++;
+    glViewport(x, y, width, height);
+}
+
+void GLState::SetCapability(GLenum capability, bool enable)
+{
+    int index = CapabilityIndex(capability);
+    if (index < 0)
+    {
+        stats.issued++;
+    }
+    else if (!Update(capabilities[index], enable ? 1 : 0))
+    {
+        return;
+    }
+
+    if (enable)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void GLState::Enable(GLenum capability)
+{
+    SetCapability(capability, true);
+}
+
+void GLState::Disable(GLenum capability)
+{
+    SetCapability(capability, false);
+}
+
+void GLState::BlendFunc(GLenum sourceFactor, GLenum destFactor)
+{
+    if (blendSource == sourceFactor && blendDest == destFactor)
+    {
+        stats.skipped++;
+        return;
+    }
+    blendSource = sourceFactor;
+    blendDest = destFactor;
+    stats.issued++;
+    glBlendFunc(sourceFactor, destFactor);
+}
+
+void GLState::DepthFunc(GLenum func)
+{
+    if (Update(depthFunc, func))
+    {
+        glDepthFunc(func);
+    }
+}
+
+void GLState::DepthMask(GLboolean flag)
+{
+    if (Update(depthMask, flag ? 1 : 0))
+    {
+        glDepthMask(flag);
+    }
+}
+
+void GLState::CullFace(GLenum mode)
+{
+    if (Update(cullFace, mode))
+    {
+        glCullFace(mode);
+    }
+}
+
+void GLState::DeleteTextures(GLsizei count, const GLuint* ids)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (ids[i] == 0) continue;
+        for (auto& unit : textures)
+        {
+            for (GLuint& texture : unit)
+            {
+                if (texture == ids[i]) texture = 0;
+            }
+        }
+    }
+    glDeleteTextures(count, ids);
+}
+
+void GLState::DeleteVertexArrays(GLsizei count, const GLuint* arrays)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (arrays[i] != 0 && vertexArray == arrays[i]) vertexArray = 0;
+    }
+    glDeleteVertexArrays(count, arrays);
+}
+
+void GLState::DeleteFramebuffers(GLsizei count, const GLuint* framebuffers)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (framebuffers[i] == 0) continue;
+        if (drawFramebuffer == framebuffers[i]) drawFramebuffer = 0;
+        if (readFramebuffer == framebuffers[i]) readFramebuffer = 0;
+    }
+    glDeleteFramebuffers(count, framebuffers);
+}
+
+void GLState::DeleteSamplers(GLsizei count, const GLuint* ids)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (ids[i] == 0) continue;
+        for (GLuint& sampler : samplers)
+        {
+            if (sampler == ids[i]) sampler = 0;
+        }
+    }
+    glDeleteSamplers(count, ids);
+}
+
+void GLState::DeleteProgram(GLuint id)
+{
+    // The program stays current until another one is bound; mark the slot
+    // unknown so the next UseProgram is always issued
+    if (id != 0 && program == id)
+    {
+        program = UNKNOWN;
+    }
+    glDeleteProgram(id);
+}
@@ -0,0 +1,86 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer()
+    : current(0), initialized(false), lastMs(0.0), totalMs(0.0), sampleCount(0)
+{
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        queries[i] = 0;
+        pending[i] = false;
+        discard[i] = false;
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    Cleanup();
+}
+
+void GpuTimer::Initialize()
+{
+    if (initialized) return;
+
+    glGenQueries(QUERY_COUNT, queries);
+    initialized = true;
+}
+
+void GpuTimer::Cleanup()
+{
+    if (!initialized) return;
+
+    glDeleteQueries(QUERY_COUNT, queries);
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        queries[i] = 0;
+        pending[i] = false;
+        discard[i] = false;
+    }
+    initialized = false;
+}
+
+void GpuTimer::Begin()
+{
+    if (!initialized) return;
+
+    // The slot was issued QUERY_COUNT frames ago; its result is normally ready
+    if (pending[current])
+    {
+        Collect(current);
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+}
+
+void GpuTimer::End()
+{
+    if (!initialized) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[current] = true;
+    current = (current + 1) % QUERY_COUNT;
+}
+
+void GpuTimer::Collect(int index)
+{
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(queries[index], GL_QUERY_RESULT, &elapsedNs);
+    pending[index] = false;
+    if (discard[index])
+    {
+        discard[index] = false;
+        return;
+    }
+
+    lastMs = static_cast<double>(elapsedNs) / 1.0e6;
+    totalMs += lastMs;
+    sampleCount++;
+}
+
+void GpuTimer::ResetAverage()
+{
+    totalMs = 0.0;
+    sampleCount = 0;
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        discard[i] = pending[i];
+    }
+}
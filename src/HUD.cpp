@@ -1,5 +1,13 @@
 #include "HUD.h"
+#include "GLState.h"
 #include <iostream>
+#include <cstring>
+
+namespace {
+    // Set for every line of text; constexpr so the hashes are compile-time constants
+    constexpr UniformId TEXT_COLOR("textColor");
+    constexpr UniformId PROJECTION("projection");
+}
 
 // 8x8 bitmap font (ASCII 32-127)
 // Simplified font data for essential characters
@@ -166,7 +174,7 @@ const unsigned char FONT_8x8[96][8] = {
     {0x31,0x6B,0x46,0x00,0x00,0x00,0x00,0x00}, // ~ 126
 };
 
-HUD::HUD() : fontTexture(0), textVAO(0), textVBO(0), textShader(0) {}
+HUD::HUD() : fontTexture(0), textVAO(0), textVBO(0) {}
 
 HUD::~HUD() {
     Cleanup();
@@ -175,7 +183,7 @@ HUD::~HUD() {
 void HUD::Initialize() {
     CreateFontTexture();
     SetupRenderData();
-    textShader = CompileTextShader();
+    CompileTextShader();
 }
 
 void HUD::CreateFontTexture() {
@@ -207,7 +215,7 @@ void HUD::CreateFontTexture() {
     
     // Create OpenGL texture
     glGenTextures(1, &fontTexture);
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
+    GLState::BindTexture(GL_TEXTURE_2D, fontTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, atlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, atlasData);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -221,7 +229,7 @@ void HUD::SetupRenderData() {
     glGenVertexArrays(1, &textVAO);
     glGenBuffers(1, &textVBO);
     
-    glBindVertexArray(textVAO);
+    GLState::BindVertexArray(textVAO);
     glBindBuffer(GL_ARRAY_BUFFER, textVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     
@@ -229,10 +237,10 @@ void HUD::SetupRenderData() {
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-unsigned int HUD::CompileTextShader() {
+bool HUD::CompileTextShader() {
     const char* vertexShaderSource = R"(
         #version 330 core
         layout (location = 0) in vec4 vertex;
@@ -256,37 +264,20 @@ unsigned int HUD::CompileTextShader() {
         }
     )";
     
-    // Compile vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    
-    // Compile fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    
-    // Link shaders
-    unsigned int shader = glCreateProgram();
-    glAttachShader(shader, vertexShader);
-    glAttachShader(shader, fragmentShader);
-    glLinkProgram(shader);
-    
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    return shader;
+    return textShader.LoadFromSource(vertexShaderSource, fragmentShaderSource, "HUD text");
 }
 
 void HUD::RenderText(const std::string& text, float x, float y, float scale, const glm::vec3& color) {
-    glUseProgram(textShader);
-    glUniform3f(glGetUniformLocation(textShader, "textColor"), color.x, color.y, color.z);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(textVAO);
+    textShader.Use();
+    textShader.SetVec3(TEXT_COLOR, color);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, fontTexture);
+    GLState::BindVertexArray(textVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
     
     // Use orthographic projection (screen coordinates)
     glm::mat4 projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
-    glUniformMatrix4fv(glGetUniformLocation(textShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    textShader.SetMat4(PROJECTION, projection);
     
     float xpos = x;
     for (char c : text) {
@@ -315,23 +306,18 @@ void HUD::RenderText(const std::string& text, float x, float y, float scale, con
             { xpos + w, y + h,   texX + texW,  texY }
         };
         
-        glBindTexture(GL_TEXTURE_2D, fontTexture);
-        glBindBuffer(GL_ARRAY_BUFFER, textVBO);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
         glDrawArrays(GL_TRIANGLES, 0, 6);
         
         xpos += w;
     }
     
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void HUD::Cleanup() {
-    if (fontTexture) glDeleteTextures(1, &fontTexture);
-    if (textVAO) glDeleteVertexArrays(1, &textVAO);
+    if (fontTexture) GLState::DeleteTextures(1, &fontTexture);
+    if (textVAO) GLState::DeleteVertexArrays(1, &textVAO);
     if (textVBO) glDeleteBuffers(1, &textVBO);
-    if (textShader) glDeleteProgram(textShader);
+    textShader.Delete();
 }
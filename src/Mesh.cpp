@@ -1,4 +1,5 @@
 #include "Mesh.h"
+#include "GLState.h"
 
 Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
 {
@@ -6,6 +7,18 @@ Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std:
     this->indices = indices;
     this->textures = textures;
 
+    // Resolve sampler names once instead of building strings every draw
+    unsigned int diffuseNr = 1;
+    for (const auto& texture : this->textures)
+    {
+        std::string number;
+        if (texture.Type == "diffuse")
+            number = std::to_string(diffuseNr++);
+
+        std::string uniformName = "material." + texture.Type + number;
+        textureUniforms.push_back(UniformId(UniformId::Hash(uniformName.c_str())));
+    }
+
     setupMesh();
 }
 
@@ -15,7 +28,7 @@ void Mesh::setupMesh()
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
@@ -35,39 +48,26 @@ void Mesh::setupMesh()
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
 
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-void Mesh::Draw(unsigned int shaderProgram)
+void Mesh::Draw(const Shader& shader)
 {
-    // Bind textures
-    unsigned int diffuseNr = 1;
+    // Bind textures (Texture::Bind selects the unit; GLState skips repeats)
     for (unsigned int i = 0; i < textures.size(); i++)
     {
-        glActiveTexture(GL_TEXTURE0 + i);
-
-        // Set uniform
-        std::string number;
-        std::string name = textures[i].Type;
-        if (name == "diffuse")
-            number = std::to_string(diffuseNr++);
-
-        glUniform1i(glGetUniformLocation(shaderProgram, ("material." + name + number).c_str()), i);
+        shader.SetInt(textureUniforms[i], static_cast<int>(i));
         textures[i].Bind(i);
     }
 
-    // Draw mesh
-    glBindVertexArray(VAO);
+    // Draw mesh; the VAO stays bound so the next draw of the same mesh is free
+    GLState::BindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    // Reset to defaults
-    glActiveTexture(GL_TEXTURE0);
 }
 
 void Mesh::Delete()
 {
-    glDeleteVertexArrays(1, &VAO);
+    GLState::DeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
 
@@ -40,10 +40,10 @@ void Model::applyFallbackTextureIfNeeded(std::vector<Texture>& textures)
     }
 }
 
-void Model::Draw(unsigned int shaderProgram)
+void Model::Draw(const Shader& shader)
 {
     for (unsigned int i = 0; i < meshes.size(); i++)
-        meshes[i].Draw(shaderProgram);
+        meshes[i].Draw(shader);
 }
 
 void Model::Delete()
@@ -1,87 +1,52 @@
 #include "PostProcessor.h"
+#include "GLState.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
-
-// Helper function to load shader
-static std::string LoadShaderSource(const char* path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "[ERROR] Failed to open shader: " << path << std::endl;
-        return "";
-    }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
-}
-
-// Helper function to compile shader
-static unsigned int CompileShader(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode = LoadShaderSource(vertexPath);
-    std::string fragmentCode = LoadShaderSource(fragmentPath);
-
-    if (vertexCode.empty() || fragmentCode.empty()) {
-        std::cerr << "[ERROR] Shader source empty" << std::endl;
-        return 0;
-    }
-
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cerr << "[ERROR] Vertex shader compilation failed: " << vertexPath << "\n" << infoLog << std::endl;
-        return 0;
-    }
-
-    unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cerr << "[ERROR] Fragment shader compilation failed: " << fragmentPath << "\n" << infoLog << std::endl;
-        glDeleteShader(vertex);
-        return 0;
-    }
-
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
-
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 512, NULL, infoLog);
-        std::cerr << "[ERROR] Shader program linking failed\n" << infoLog << std::endl;
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-        return 0;
-    }
-
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-
-    return program;
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Uniforms set every frame; namespace-scope constexpr guarantees the
+    // name hashes are computed at compile time, not per call
+    constexpr UniformId THRESHOLD("threshold");
+    constexpr UniformId PREFILTER("prefilter");
+    constexpr UniformId INV_VIEW_PROJECTION("invViewProjection");
+    constexpr UniformId PREV_VIEW_PROJECTION("prevViewProjection");
+    constexpr UniformId JITTER("jitter");
+    constexpr UniformId TEXEL_SIZE("texelSize");
+    constexpr UniformId RENDER_TEXEL_SIZE("renderTexelSize");
+    constexpr UniformId HISTORY_WEIGHT("historyWeight");
+    constexpr UniformId PROJECTION("projection");
+    constexpr UniformId INV_PROJECTION("invProjection");
+    constexpr UniformId DEPTH_TEXEL_SIZE("depthTexelSize");
+    constexpr UniformId DIRECTION("direction");
+    constexpr UniformId TAP_COUNT("tapCount");
+    constexpr UniformId WEIGHTS("weights");
+    constexpr UniformId OFFSETS("offsets");
+    constexpr UniformId IMAGE("image");
+    constexpr UniformId HORIZONTAL("horizontal");
+    constexpr UniformId HDR_BUFFER("hdrBuffer");
+    constexpr UniformId BLOOM_BLUR("bloomBlur");
+    constexpr UniformId EXPOSURE("exposure");
+    constexpr UniformId ENABLE_BLOOM("enableBloom");
+    constexpr UniformId ENABLE_GAMMA("enableGamma");
+    constexpr UniformId BLOOM_STRENGTH("bloomStrength");
+    constexpr UniformId DEBUG_MODE("debugMode");
 }
 
 PostProcessor::PostProcessor(unsigned int width, unsigned int height)
-    : width(width), height(height), initialized(false),
+    : width(width), height(height), renderScale(1.0f), renderWidth(width), renderHeight(height),
+      initialized(false),
       hdrFBO(0), hdrColorBuffer(0), hdrDepthBuffer(0),
-      brightFBO(0), brightColorBuffer(0),
-      quadVAO(0), quadVBO(0),
-      postprocessShader(0), bloomExtractShader(0), blurShader(0)
+      historyIndex(0), historyValid(false), temporalUpsampling(false),
+      viewProjection(1.0f), prevViewProjection(1.0f), jitter(0.0f),
+      occlusionFBO(0), occlusionTexture(0),
+      bloomThreshold(1.0f), bloomLevels(6), bloomMode(BLOOM_DUAL_FILTER),
+      bloomLastPass(-1), bloomTimed(false), autoExposureEnabled(false),
+      blurRadius(4), blurTapCount(0),
+      quadVAO(0), quadVBO(0)
 {
-    bloomFBO[0] = bloomFBO[1] = 0;
-    bloomColorBuffers[0] = bloomColorBuffers[1] = 0;
+    historyFBO[0] = historyFBO[1] = 0;
+    historyTextures[0] = historyTextures[1] = 0;
 }
 
 PostProcessor::~PostProcessor() {
@@ -95,8 +60,14 @@ void PostProcessor::Initialize() {
     CreateFramebuffers();
     CreateScreenQuad();
     LoadShaders();
+    bloomTimer.Initialize();
+    temporalTimer.Initialize();
+    occlusionTimer.Initialize();
+    if (luminanceShader.IsValid()) {
+        autoExposure.Initialize();
+    }
 
-    if (postprocessShader != 0) {
+    if (postprocessShader.IsValid()) {
         initialized = true;
         std::cout << "[OK] Post-processor initialized successfully\n" << std::endl;
     } else {
@@ -105,66 +76,73 @@ void PostProcessor::Initialize() {
 }
 
 void PostProcessor::CreateFramebuffers() {
-    // HDR Framebuffer with MRT (Multiple Render Targets)
+    renderWidth = std::max(static_cast<unsigned int>(width * renderScale), 1u);
+    renderHeight = std::max(static_cast<unsigned int>(height * renderScale), 1u);
+
+    // HDR Framebuffer: the scene pass writes a single color target
     glGenFramebuffers(1, &hdrFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
 
     // COLOR_ATTACHMENT0: Main HDR scene color
     glGenTextures(1, &hdrColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, hdrColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+    GLState::BindTexture(GL_TEXTURE_2D, hdrColorBuffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, renderWidth, renderHeight, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, hdrColorBuffer, 0);
 
-    // COLOR_ATTACHMENT1: Bright color for bloom
-    glGenTextures(1, &brightColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, brightColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Depth texture (sampled by the temporal velocity pass)
+    glGenTextures(1, &hdrDepthBuffer);
+    GLState::BindTexture(GL_TEXTURE_2D, hdrDepthBuffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, renderWidth, renderHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, brightColorBuffer, 0);
-
-    // Enable MRT - render to both color attachments
-    GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
-    glDrawBuffers(2, drawBuffers);
-    std::cout << "[HDR FBO] MRT enabled: COLOR_ATTACHMENT0 + COLOR_ATTACHMENT1" << std::endl;
-
-    // Depth renderbuffer
-    glGenRenderbuffers(1, &hdrDepthBuffer);
-    glBindRenderbuffer(GL_RENDERBUFFER, hdrDepthBuffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, hdrDepthBuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, hdrDepthBuffer, 0);
 
     if (!CheckFramebufferStatus(hdrFBO, "HDR")) return;
 
-    // Bloom ping-pong framebuffers (half resolution for performance)
-    unsigned int bloomWidth = width / 2;
-    unsigned int bloomHeight = height / 2;
-
-    // We'll use brightColorBuffer as source, so we only need ping-pong buffers
+    // Temporal history: output resolution, persists across frames so it is not pooled
     for (int i = 0; i < 2; i++) {
-        glGenFramebuffers(1, &bloomFBO[i]);
-        glBindFramebuffer(GL_FRAMEBUFFER, bloomFBO[i]);
+        glGenFramebuffers(1, &historyFBO[i]);
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, historyFBO[i]);
 
-        glGenTextures(1, &bloomColorBuffers[i]);
-        glBindTexture(GL_TEXTURE_2D, bloomColorBuffers[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, bloomWidth, bloomHeight, 0, GL_RGBA, GL_FLOAT, NULL);
+        glGenTextures(1, &historyTextures[i]);
+        GLState::BindTexture(GL_TEXTURE_2D, historyTextures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, bloomColorBuffers[i], 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, historyTextures[i], 0);
 
-        if (!CheckFramebufferStatus(bloomFBO[i], i == 0 ? "Bloom Ping" : "Bloom Pong")) return;
+        if (!CheckFramebufferStatus(historyFBO[i], "Temporal History")) return;
     }
+    // New targets hold nothing worth accumulating
+    historyValid = false;
+
+    // SSAO result: half render resolution bounds its cost whatever the output size
+    glGenFramebuffers(1, &occlusionFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, occlusionFBO);
+
+    glGenTextures(1, &occlusionTexture);
+    GLState::BindTexture(GL_TEXTURE_2D, occlusionTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, std::max(renderWidth / 2, 1u), std::max(renderHeight / 2, 1u), 0, GL_RG, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, occlusionTexture, 0);
+
+    if (!CheckFramebufferStatus(occlusionFBO, "Ambient Occlusion")) return;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    std::cout << "[POST-PROCESSOR] Framebuffers created with MRT support" << std::endl;
+    // Bright pass, bloom and blur targets are transient: the frame graph
+    // takes them from its pool each frame at the current render size
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    std::cout << "[POST-PROCESSOR] HDR target " << renderWidth << "x" << renderHeight << " created" << std::endl;
 }
 
 void PostProcessor::CreateScreenQuad() {
@@ -180,7 +158,7 @@ void PostProcessor::CreateScreenQuad() {
 
     glGenVertexArrays(1, &quadVAO);
     glGenBuffers(1, &quadVBO);
-    glBindVertexArray(quadVAO);
+    GLState::BindVertexArray(quadVAO);
     glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
@@ -188,30 +166,72 @@ void PostProcessor::CreateScreenQuad() {
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
 void PostProcessor::LoadShaders() {
     std::cout << "Loading post-process shaders..." << std::endl;
 
-    postprocessShader = CompileShader("shaders/postprocess.vert", "shaders/postprocess.frag");
-    if (postprocessShader) {
+    if (postprocessShader.LoadFromFiles("shaders/postprocess.vert", "shaders/postprocess.frag")) {
         std::cout << "[OK] Post-process shader loaded" << std::endl;
     }
 
-    bloomExtractShader = CompileShader("shaders/postprocess.vert", "shaders/bloom_extract.frag");
-    if (bloomExtractShader) {
+    if (bloomExtractShader.LoadFromFiles("shaders/postprocess.vert", "shaders/bloom_extract.frag")) {
+        bloomExtractShader.Use();
+        bloomExtractShader.SetInt("hdrBuffer", 0);
         std::cout << "[OK] Bloom extract shader loaded" << std::endl;
     }
 
-    blurShader = CompileShader("shaders/postprocess.vert", "shaders/blur.frag");
-    if (blurShader) {
+    if (blurShader.LoadFromFiles("shaders/postprocess.vert", "shaders/blur.frag")) {
         std::cout << "[OK] Blur shader loaded" << std::endl;
+        SetBlurRadius(blurRadius);
+    }
+
+    if (bloomDownsampleShader.LoadFromFiles("shaders/postprocess.vert", "shaders/bloom_downsample.frag") &&
+        bloomUpsampleShader.LoadFromFiles("shaders/postprocess.vert", "shaders/bloom_upsample.frag")) {
+        bloomDownsampleShader.Use();
+        bloomDownsampleShader.SetInt("source", 0);
+        bloomUpsampleShader.Use();
+        bloomUpsampleShader.SetInt("source", 0);
+        bloomUpsampleShader.SetFloat("filterRadius", 1.0f);
+        std::cout << "[OK] Dual-filter bloom shaders loaded" << std::endl;
+    } else {
+        // Without the chain shaders the Gaussian path still works
+        bloomMode = BLOOM_GAUSSIAN;
+    }
+
+    if (velocityShader.LoadFromFiles("shaders/postprocess.vert", "shaders/velocity.frag") &&
+        taaResolveShader.LoadFromFiles("shaders/postprocess.vert", "shaders/taa_resolve.frag")) {
+        velocityShader.Use();
+        velocityShader.SetInt("depthBuffer", 0);
+        taaResolveShader.Use();
+        taaResolveShader.SetInt("currentColor", 0);
+        taaResolveShader.SetInt("velocityBuffer", 1);
+        taaResolveShader.SetInt("history", 2);
+        std::cout << "[OK] Temporal upsampling shaders loaded" << std::endl;
+    }
+
+    if (ssaoShader.LoadFromFiles("shaders/postprocess.vert", "shaders/ssao.frag") &&
+        ssaoBlurShader.LoadFromFiles("shaders/postprocess.vert", "shaders/ssao_blur.frag")) {
+        ssaoShader.Use();
+        ssaoShader.SetInt("depthBuffer", 0);
+        ssaoShader.SetFloat("radius", 1.0f);
+        ssaoShader.SetFloat("intensity", 1.5f);
+        ssaoBlurShader.Use();
+        ssaoBlurShader.SetInt("occlusionBuffer", 0);
+        std::cout << "[OK] SSAO shaders loaded" << std::endl;
+    }
+
+    if (luminanceShader.LoadFromFiles("shaders/postprocess.vert", "shaders/luminance.frag")) {
+        luminanceShader.Use();
+        luminanceShader.SetInt("hdrBuffer", 0);
+        luminanceShader.SetVec2("texelSize", glm::vec2(1.0f / AutoExposure::SIZE));
+        std::cout << "[OK] Luminance shader loaded" << std::endl;
     }
 }
 
 void PostProcessor::BeginRender() {
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
 
     // DEBUG: Confirm HDR FBO is bound
     GLint currentFBO;
@@ -222,40 +242,326 @@ void PostProcessor::BeginRender() {
         debugOnce = true;
     }
 
-    glViewport(0, 0, width, height);
+    GLState::Viewport(0, 0, renderWidth, renderHeight);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);  // CRITICAL: Re-enable depth test for scene rendering
+    GLState::Enable(GL_DEPTH_TEST);  // CRITICAL: Re-enable depth test for scene rendering
 }
 
 void PostProcessor::EndRender() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void PostProcessor::ApplyBloom() {
-    // brightColorBuffer (COLOR_ATTACHMENT1) already contains bright pixels from MRT
-    // We skip the extraction step and go straight to blur
-    
-    // Ping-pong blur (10 iterations = 5 horizontal + 5 vertical)
-    bool horizontal = true;
-    int iterations = 10;
+FrameGraph::ResourceId PostProcessor::AddBrightPass(FrameGraph::ResourceId hdr) {
+    // Threshold the HDR scene into a half-resolution target (Gaussian path and bright-pass view)
+    FrameGraph::ResourceId bright = frameGraph.CreateTarget("Bright", HalfResolutionDesc());
+    frameGraph.AddPass("BrightExtract", { hdr }, { bright }, [this, hdr, bright](FrameGraph& graph) {
+        if (bloomMode == BLOOM_GAUSSIAN && bloomTimed) bloomTimer.Begin();
+        graph.BindOutput(bright);
+        GLState::Disable(GL_BLEND);
+        bloomExtractShader.Use();
+        bloomExtractShader.SetFloat(THRESHOLD, bloomThreshold);
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(hdr));
+        RenderScreenQuad();
+    });
+    return bright;
+}
 
-    glUseProgram(blurShader);
+FrameGraph::ResourceId PostProcessor::AddGaussianBloom(FrameGraph::ResourceId bright) {
+    // Ping-pong blur (10 passes = 5 horizontal + 5 vertical). Every pass
+    // writes a new target; the pool aliases them down to two textures
+    const int iterations = 5;
+    RenderTargetDesc desc = HalfResolutionDesc();
+    FrameGraph::ResourceId source = bright;
     for (int i = 0; i < iterations; i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, bloomFBO[horizontal]);
-        glViewport(0, 0, width / 2, height / 2);
-        glUniform1i(glGetUniformLocation(blurShader, "horizontal"), horizontal);
+        FrameGraph::ResourceId horizontal = frameGraph.CreateTarget("BlurH", desc);
+        FrameGraph::ResourceId vertical = frameGraph.CreateTarget("BlurV", desc);
+        frameGraph.AddPass("BlurH", { source }, { horizontal }, [this, source, horizontal](FrameGraph& graph) {
+            graph.BindOutput(horizontal);
+            BlurDirection(graph.GetTexture(source), true);
+        });
+        bloomLastPass = frameGraph.AddPass("BlurV", { horizontal }, { vertical }, [this, horizontal, vertical, i](FrameGraph& graph) {
+            graph.BindOutput(vertical);
+            BlurDirection(graph.GetTexture(horizontal), false);
+            if (i == iterations - 1 && bloomTimed) bloomTimer.End();
+        });
+        source = vertical;
+    }
+    return source;
+}
+
+FrameGraph::ResourceId PostProcessor::AddDualFilterBloom(FrameGraph::ResourceId hdr) {
+    // Each level reads a quarter of the previous one's pixels, so the whole
+    // chain costs about one extra half-resolution pass whatever the radius
+    FrameGraph::ResourceId mips[MAX_BLOOM_LEVELS];
+    RenderTargetDesc desc = HalfResolutionDesc();
+    for (int i = 0; i < bloomLevels; i++) {
+        mips[i] = frameGraph.CreateTarget("BloomMip", desc);
+        desc.width = std::max(desc.width / 2, 1u);
+        desc.height = std::max(desc.height / 2, 1u);
+    }
 
-        glActiveTexture(GL_TEXTURE0);
-        // First iteration uses brightColorBuffer, subsequent iterations ping-pong
-        glBindTexture(GL_TEXTURE_2D, i == 0 ? brightColorBuffer : bloomColorBuffers[!horizontal]);
-        glUniform1i(glGetUniformLocation(blurShader, "image"), 0);
+    // Downsample: HDR scene -> level 0 -> ... -> level N-1 (13 taps each);
+    // the first pass applies the bright-pass threshold while it reads the scene
+    for (int i = 0; i < bloomLevels; i++) {
+        FrameGraph::ResourceId source = (i == 0) ? hdr : mips[i - 1];
+        FrameGraph::ResourceId dest = mips[i];
+        bool last = (bloomLevels == 1);
+        bloomLastPass = frameGraph.AddPass("BloomDown", { source }, { dest }, [this, source, dest, i, last](FrameGraph& graph) {
+            if (i == 0 && bloomTimed) bloomTimer.Begin();
+            graph.BindOutput(dest);
+            GLState::Disable(GL_BLEND);
+            bloomDownsampleShader.Use();
+            bloomDownsampleShader.SetFloat(THRESHOLD, bloomThreshold);
+            bloomDownsampleShader.SetBool(PREFILTER, i == 0);
+            GLState::ActiveTexture(GL_TEXTURE0);
+            GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(source));
+            RenderScreenQuad();
+            if (last && bloomTimed) bloomTimer.End();
+        });
+    }
 
+    // Upsample: tent-filter each level and add it onto the next larger one,
+    // so level 0 ends up holding the sum of every level
+    for (int i = bloomLevels - 1; i > 0; i--) {
+        FrameGraph::ResourceId source = mips[i];
+        FrameGraph::ResourceId dest = mips[i - 1];
+        bloomLastPass = frameGraph.AddPass("BloomUp", { source, dest }, { dest }, [this, source, dest, i](FrameGraph& graph) {
+            graph.BindOutput(dest);
+            bloomUpsampleShader.Use();
+            GLState::Enable(GL_BLEND);
+            GLState::BlendFunc(GL_ONE, GL_ONE);
+            GLState::ActiveTexture(GL_TEXTURE0);
+            GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(source));
+            RenderScreenQuad();
+            GLState::Disable(GL_BLEND);
+            if (i == 1 && bloomTimed) bloomTimer.End();
+        });
+    }
+    return mips[0];
+}
+
+void PostProcessor::AddLuminancePass(FrameGraph::ResourceId hdr) {
+    // The CPU consumes the result, so the target is an output in its own right
+    FrameGraph::ResourceId luminance = frameGraph.Import("Luminance", autoExposure.GetTexture(),
+                                                         autoExposure.GetFramebuffer(), AutoExposure::SIZE, AutoExposure::SIZE);
+    frameGraph.AddPass("Luminance", { hdr }, { luminance }, [this, hdr, luminance](FrameGraph& graph) {
+        autoExposure.BeginMeasure();
+        graph.BindOutput(luminance);
+        GLState::Disable(GL_BLEND);
+        luminanceShader.Use();
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(hdr));
         RenderScreenQuad();
-        horizontal = !horizontal;
+        autoExposure.Reduce();
+        autoExposure.EndMeasure();
+    });
+    frameGraph.MarkOutput(luminance);
+}
+
+FrameGraph::ResourceId PostProcessor::AddTemporalResolve(FrameGraph::ResourceId hdr) {
+    FrameGraph::ResourceId depth = frameGraph.Import("SceneDepth", hdrDepthBuffer, 0, renderWidth, renderHeight);
+    FrameGraph::ResourceId history = frameGraph.Import("History", historyTextures[historyIndex], historyFBO[historyIndex], width, height);
+    FrameGraph::ResourceId resolved = frameGraph.Import("Resolved", historyTextures[1 - historyIndex],
+                                                       historyFBO[1 - historyIndex], width, height);
+    FrameGraph::ResourceId velocity = frameGraph.CreateTarget("Velocity", RenderTargetDesc{ renderWidth, renderHeight, GL_RG16F });
+
+    // Per-pixel offset to last frame's position, from depth and the two view-projections
+    glm::mat4 invViewProjection = glm::inverse(viewProjection);
+    frameGraph.AddPass("Velocity", { depth }, { velocity }, [this, depth, velocity, invViewProjection](FrameGraph& graph) {
+        temporalTimer.Begin();
+        graph.BindOutput(velocity);
+        GLState::Disable(GL_BLEND);
+        velocityShader.Use();
+        velocityShader.SetMat4(INV_VIEW_PROJECTION, invViewProjection);
+        velocityShader.SetMat4(PREV_VIEW_PROJECTION, prevViewProjection);
+        velocityShader.SetVec2(JITTER, jitter);
+        velocityShader.SetVec2(TEXEL_SIZE, glm::vec2(1.0f / renderWidth, 1.0f / renderHeight));
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(depth));
+        RenderScreenQuad();
+    });
+
+    // Accumulate into the output-resolution history; the result is next frame's history
+    frameGraph.AddPass("TemporalResolve", { hdr, velocity, history }, { resolved },
+        [this, hdr, velocity, history, resolved](FrameGraph& graph) {
+        graph.BindOutput(resolved);
+        taaResolveShader.Use();
+        taaResolveShader.SetVec2(JITTER, jitter);
+        taaResolveShader.SetVec2(RENDER_TEXEL_SIZE, glm::vec2(1.0f / renderWidth, 1.0f / renderHeight));
+        // ~10% of each new frame: enough samples to cover the jitter sequence
+        taaResolveShader.SetFloat(HISTORY_WEIGHT, historyValid ? 0.9f : 0.0f);
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(hdr));
+        GLState::ActiveTexture(GL_TEXTURE1);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(velocity));
+        GLState::ActiveTexture(GL_TEXTURE2);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(history));
+        RenderScreenQuad();
+        temporalTimer.End();
+    });
+    return resolved;
+}
+
+void PostProcessor::SetTemporalUpsampling(bool enable) {
+    if (enable && !taaResolveShader.IsValid()) return;
+    if (enable != temporalUpsampling) {
+        historyValid = false;
     }
+    temporalUpsampling = enable;
+}
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void PostProcessor::SetCameraMatrices(const glm::mat4& currentViewProjection, const glm::vec2& currentJitter) {
+    prevViewProjection = viewProjection;
+    viewProjection = currentViewProjection;
+    jitter = currentJitter;
+}
+
+void PostProcessor::ComputeAmbientOcclusion(const glm::mat4& projection) {
+    if (!IsAmbientOcclusionAvailable()) return;
+
+    unsigned int halfWidth = std::max(renderWidth / 2, 1u);
+    unsigned int halfHeight = std::max(renderHeight / 2, 1u);
+
+    occlusionGraph.Reset();
+    FrameGraph::ResourceId depth = occlusionGraph.Import("SceneDepth", hdrDepthBuffer, 0, renderWidth, renderHeight);
+    FrameGraph::ResourceId result = occlusionGraph.Import("AmbientOcclusion", occlusionTexture, occlusionFBO, halfWidth, halfHeight);
+    RenderTargetDesc desc{ halfWidth, halfHeight, GL_RG16F };
+    FrameGraph::ResourceId raw = occlusionGraph.CreateTarget("OcclusionRaw", desc);
+    FrameGraph::ResourceId blurred = occlusionGraph.CreateTarget("OcclusionBlurH", desc);
+
+    glm::mat4 invProjection = glm::inverse(projection);
+    occlusionGraph.AddPass("SSAO", { depth }, { raw }, [this, depth, raw, projection, invProjection](FrameGraph& graph) {
+        occlusionTimer.Begin();
+        graph.BindOutput(raw);
+        ssaoShader.Use();
+        ssaoShader.SetMat4(PROJECTION, projection);
+        ssaoShader.SetMat4(INV_PROJECTION, invProjection);
+        ssaoShader.SetVec2(DEPTH_TEXEL_SIZE, glm::vec2(1.0f / renderWidth, 1.0f / renderHeight));
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(depth));
+        RenderScreenQuad();
+    });
+    occlusionGraph.AddPass("SSAOBlurH", { raw }, { blurred }, [this, raw, blurred, halfWidth](FrameGraph& graph) {
+        graph.BindOutput(blurred);
+        ssaoBlurShader.Use();
+        ssaoBlurShader.SetVec2(DIRECTION, glm::vec2(1.0f / halfWidth, 0.0f));
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(raw));
+        RenderScreenQuad();
+    });
+    occlusionGraph.AddPass("SSAOBlurV", { blurred }, { result }, [this, blurred, result, halfHeight](FrameGraph& graph) {
+        graph.BindOutput(result);
+        ssaoBlurShader.Use();
+        ssaoBlurShader.SetVec2(DIRECTION, glm::vec2(0.0f, 1.0f / halfHeight));
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(blurred));
+        RenderScreenQuad();
+        occlusionTimer.End();
+    });
+    occlusionGraph.MarkOutput(result);
+
+    // Fullscreen passes must not depth-test against (or write) the scene depth they read
+    GLState::Disable(GL_DEPTH_TEST);
+    GLState::Disable(GL_BLEND);
+    occlusionGraph.Compile();
+    occlusionGraph.Execute();
+
+    // Back to the scene target for the lit pass
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
+    GLState::Viewport(0, 0, renderWidth, renderHeight);
+    GLState::Enable(GL_DEPTH_TEST);
+}
+
+void PostProcessor::UpdateExposure(float deltaTime) {
+    if (autoExposureEnabled) {
+        autoExposure.Update(deltaTime);
+    }
+}
+
+RenderTargetDesc PostProcessor::HalfResolutionDesc() const {
+    return RenderTargetDesc{ std::max(renderWidth / 2, 1u), std::max(renderHeight / 2, 1u), GL_RGBA16F };
+}
+
+void PostProcessor::SetBloomMode(BloomMode mode) {
+    if (mode == bloomMode) return;
+    if (mode == BLOOM_DUAL_FILTER && !bloomUpsampleShader.IsValid()) return;
+
+    std::cout << "[Bloom] " << GetBloomModeName() << ": " << bloomTimer.GetAverageMs()
+              << " ms avg over " << bloomTimer.GetSampleCount() << " frames" << std::endl;
+    bloomTimer.ResetAverage();
+    bloomMode = mode;
+}
+
+void PostProcessor::SetBloomLevels(int levels) {
+    levels = std::max(1, std::min(levels, MAX_BLOOM_LEVELS));
+    if (levels == bloomLevels) return;
+
+    bloomLevels = levels;
+    bloomTimer.ResetAverage();
+}
+
+void PostProcessor::SetBlurRadius(int radius) {
+    blurRadius = std::max(1, std::min(radius, MAX_BLUR_RADIUS));
+
+    // Discrete Gaussian over [-r, r]; sigma = r / 2.25 reproduces the old
+    // 9-tap table at r = 4. Normalised so the full kernel sums to one
+    float sigma = blurRadius / 2.25f;
+    float discrete[MAX_BLUR_RADIUS + 1];
+    float sum = 0.0f;
+    for (int i = 0; i <= blurRadius; i++) {
+        discrete[i] = std::exp(-0.5f * i * i / (sigma * sigma));
+        sum += (i == 0) ? discrete[i] : 2.0f * discrete[i];
+    }
+    for (int i = 0; i <= blurRadius; i++) {
+        discrete[i] /= sum;
+    }
+
+    // Fold texels (1,2), (3,4), ... into one bilinear fetch each: sampling at
+    // the weighted position between them returns w1*t1 + w2*t2 for weight w1 + w2
+    blurWeights[0] = discrete[0];
+    blurOffsets[0] = 0.0f;
+    blurTapCount = 1;
+    for (int i = 1; i <= blurRadius; i += 2) {
+        float w1 = discrete[i];
+        float w2 = (i + 1 <= blurRadius) ? discrete[i + 1] : 0.0f;
+        blurWeights[blurTapCount] = w1 + w2;
+        blurOffsets[blurTapCount] = (i * w1 + (i + 1) * w2) / (w1 + w2);
+        blurTapCount++;
+    }
+
+    if (blurShader.IsValid()) {
+        blurShader.Use();
+        blurShader.SetInt(TAP_COUNT, blurTapCount);
+        blurShader.SetFloatArray(WEIGHTS, blurWeights, blurTapCount);
+        blurShader.SetFloatArray(OFFSETS, blurOffsets, blurTapCount);
+    }
+    std::cout << "[Blur] Radius " << blurRadius << ": " << GetBlurFetchCount() << " fetches per direction instead of "
+              << 2 * blurRadius + 1 << std::endl;
+}
+
+void PostProcessor::SeparableBlur(unsigned int sourceTexture, unsigned int scratchFBO, unsigned int scratchTexture,
+                                  unsigned int destFBO, unsigned int blurWidth, unsigned int blurHeight) {
+    GLState::Viewport(0, 0, blurWidth, blurHeight);
+
+    // Horizontal: source -> scratch
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, scratchFBO);
+    BlurDirection(sourceTexture, true);
+
+    // Vertical: scratch -> destination
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, destFBO);
+    BlurDirection(scratchTexture, false);
+}
+
+void PostProcessor::BlurDirection(unsigned int sourceTexture, bool horizontal) {
+    // Draws into whatever framebuffer and viewport are bound
+    blurShader.Use();
+    blurShader.SetInt(IMAGE, 0);
+    blurShader.SetBool(HORIZONTAL, horizontal);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, sourceTexture);
+    RenderScreenQuad();
 }
 
 void PostProcessor::Render(float exposure, bool enableBloom, bool enableGamma) {
@@ -263,77 +569,101 @@ void PostProcessor::Render(float exposure, bool enableBloom, bool enableGamma) {
 }
 
 void PostProcessor::Render(float exposure, bool enableBloom, bool enableGamma, float bloomStrength, int debugMode) {
-    // Apply bloom if enabled (only in normal mode)
-    if (enableBloom && debugMode == 0) {
-        ApplyBloom();
+    // Describe the frame; Compile() culls whatever the composite does not read
+    frameGraph.Reset();
+    FrameGraph::ResourceId hdr = frameGraph.Import("HDR", hdrColorBuffer, hdrFBO, renderWidth, renderHeight);
+    FrameGraph::ResourceId screen = frameGraph.Import("Backbuffer", 0, 0, width, height);
+
+    // Measured ahead of bloom: its GPU timer cannot overlap the bloom timer
+    bool useAutoExposure = autoExposureEnabled && autoExposure.IsInitialized();
+    if (useAutoExposure) {
+        AddLuminancePass(hdr);
+        exposure *= autoExposure.GetExposure();
     }
 
-    // === FINAL POST-PROCESS TO SCREEN ===
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, width, height);
-    
-    // Clear to prevent leftover fragments
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    // CRITICAL: Set OpenGL state for fullscreen quad
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
-    glDisable(GL_BLEND);
-    glDisable(GL_CULL_FACE);
-
-    // Debug output (once)
-    static bool debugOnce = false;
-    if (!debugOnce) {
-        std::cout << "[POST-PROCESS] HDR texture ID: " << hdrColorBuffer << std::endl;
-        std::cout << "[POST-PROCESS] Bright texture ID: " << brightColorBuffer << std::endl;
-        std::cout << "[POST-PROCESS] Bloom texture ID: " << bloomColorBuffers[0] << std::endl;
-        debugOnce = true;
-    }
+    // Everything downstream reads the upsampled, antialiased scene when temporal upsampling is on
+    bool useTemporal = temporalUpsampling && taaResolveShader.IsValid();
+    FrameGraph::ResourceId scene = useTemporal ? AddTemporalResolve(hdr) : hdr;
 
-    glUseProgram(postprocessShader);
+    FrameGraph::ResourceId bright = AddBrightPass(scene);
+    FrameGraph::ResourceId bloom = (bloomMode == BLOOM_DUAL_FILTER) ? AddDualFilterBloom(scene) : AddGaussianBloom(bright);
 
-    // Bind the appropriate texture for each debug mode
-    glActiveTexture(GL_TEXTURE0);
-    if (debugMode == 0 || debugMode == 1) {
-        // Normal mode or HDR only: use HDR buffer
-        glBindTexture(GL_TEXTURE_2D, hdrColorBuffer);
-    } else if (debugMode == 2) {
-        // Bright pass: use bright color buffer
-        glBindTexture(GL_TEXTURE_2D, brightColorBuffer);
+    // Debug views show an intermediate target in place of the scene
+    bool useBloom = enableBloom && debugMode == 0;
+    FrameGraph::ResourceId view = scene;
+    if (debugMode == 2) {
+        view = bright;
     } else if (debugMode == 3) {
-        // Bloom blur: use blurred bloom
-        glBindTexture(GL_TEXTURE_2D, bloomColorBuffers[0]);
+        view = bloom;
     }
-    glUniform1i(glGetUniformLocation(postprocessShader, "hdrBuffer"), 0);
+    std::vector<FrameGraph::ResourceId> inputs = { view };
+    if (useBloom) inputs.push_back(bloom);
 
-    // Bloom texture (only used in normal mode)
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, bloomColorBuffers[0]);
-    glUniform1i(glGetUniformLocation(postprocessShader, "bloomBlur"), 1);
+    // The dual-filter chain sums every level, so scale it back to the Gaussian's brightness
+    if (bloomMode == BLOOM_DUAL_FILTER) {
+        bloomStrength /= static_cast<float>(bloomLevels);
+    }
 
-    // Set uniforms
-    glUniform1f(glGetUniformLocation(postprocessShader, "exposure"), exposure);
-    glUniform1i(glGetUniformLocation(postprocessShader, "enableBloom"), (enableBloom && debugMode == 0) ? 1 : 0);
-    glUniform1i(glGetUniformLocation(postprocessShader, "enableGamma"), enableGamma ? 1 : 0);
-    glUniform1f(glGetUniformLocation(postprocessShader, "bloomStrength"), bloomStrength);
-    glUniform1i(glGetUniformLocation(postprocessShader, "debugMode"), debugMode);
+    // === FINAL POST-PROCESS TO SCREEN ===
+    frameGraph.AddPass("Composite", inputs, { screen },
+        [this, screen, view, bloom, useBloom, exposure, enableGamma, bloomStrength, debugMode](FrameGraph& graph) {
+        graph.BindOutput(screen);
+
+        // Clear to prevent leftover fragments
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // CRITICAL: Set OpenGL state for fullscreen quad
+        GLState::Disable(GL_DEPTH_TEST);
+        GLState::DepthMask(GL_FALSE);
+        GLState::Disable(GL_BLEND);
+        GLState::Disable(GL_CULL_FACE);
+
+        postprocessShader.Use();
+
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, graph.GetTexture(view));
+        postprocessShader.SetInt(HDR_BUFFER, 0);
+
+        // Bloom texture (only used in normal mode)
+        GLState::ActiveTexture(GL_TEXTURE1);
+        GLState::BindTexture(GL_TEXTURE_2D, useBloom ? graph.GetTexture(bloom) : 0);
+        postprocessShader.SetInt(BLOOM_BLUR, 1);
+
+        // Set uniforms
+        postprocessShader.SetFloat(EXPOSURE, exposure);
+        postprocessShader.SetBool(ENABLE_BLOOM, useBloom);
+        postprocessShader.SetBool(ENABLE_GAMMA, enableGamma);
+        postprocessShader.SetFloat(BLOOM_STRENGTH, bloomStrength);
+        postprocessShader.SetInt(DEBUG_MODE, debugMode);
+
+        // Render fullscreen quad
+        RenderScreenQuad();
+    });
+    frameGraph.MarkOutput(screen);
+
+    frameGraph.Compile();
+    // Only time bloom on frames where its chain actually runs
+    bloomTimed = frameGraph.IsPassActive(bloomLastPass);
+    frameGraph.Execute();
+
+    // This frame's resolve becomes the next frame's history
+    if (useTemporal) {
+        historyIndex = 1 - historyIndex;
+        historyValid = true;
+    }
 
-    // Render fullscreen quad
-    RenderScreenQuad();
-    
     // Restore OpenGL state
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::DepthMask(GL_TRUE);
 }
 
 void PostProcessor::RenderScreenQuad() {
-    glBindVertexArray(quadVAO);
+    GLState::BindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
 }
 
 bool PostProcessor::CheckFramebufferStatus(unsigned int fbo, const char* name) {
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, fbo);
     GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE) {
         std::cerr << "[ERROR] " << name << " framebuffer incomplete: " << status << std::endl;
@@ -346,29 +676,63 @@ bool PostProcessor::CheckFramebufferStatus(unsigned int fbo, const char* name) {
 void PostProcessor::Resize(unsigned int newWidth, unsigned int newHeight) {
     width = newWidth;
     height = newHeight;
-    Cleanup();
-    Initialize();
+    if (!initialized) return;
+
+    // Only the HDR target is sized here; pooled targets at the old size age out
+    ReleaseFramebuffers();
+    CreateFramebuffers();
 }
 
-void PostProcessor::Cleanup() {
-    if (hdrFBO) glDeleteFramebuffers(1, &hdrFBO);
-    if (hdrColorBuffer) glDeleteTextures(1, &hdrColorBuffer);
-    if (hdrDepthBuffer) glDeleteRenderbuffers(1, &hdrDepthBuffer);
+void PostProcessor::SetRenderScale(float scale) {
+    scale = std::max(0.25f, std::min(scale, 1.0f));
+    if (scale == renderScale) return;
 
-    if (brightFBO) glDeleteFramebuffers(1, &brightFBO);
-    if (brightColorBuffer) glDeleteTextures(1, &brightColorBuffer);
+    renderScale = scale;
+    if (!initialized) return;
+
+    // Only the render targets depend on the size; shaders and the quad stay
+    ReleaseFramebuffers();
+    CreateFramebuffers();
+    std::cout << "[POST-PROCESS] Render scale " << renderScale << ": " << renderWidth << "x" << renderHeight
+              << " upscaled to " << width << "x" << height << std::endl;
+}
+
+void PostProcessor::ReleaseFramebuffers() {
+    if (hdrFBO) GLState::DeleteFramebuffers(1, &hdrFBO);
+    if (hdrColorBuffer) GLState::DeleteTextures(1, &hdrColorBuffer);
+    if (hdrDepthBuffer) GLState::DeleteTextures(1, &hdrDepthBuffer);
 
     for (int i = 0; i < 2; i++) {
-        if (bloomFBO[i]) glDeleteFramebuffers(1, &bloomFBO[i]);
-        if (bloomColorBuffers[i]) glDeleteTextures(1, &bloomColorBuffers[i]);
+        if (historyFBO[i]) GLState::DeleteFramebuffers(1, &historyFBO[i]);
+        if (historyTextures[i]) GLState::DeleteTextures(1, &historyTextures[i]);
     }
 
-    if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
+    if (occlusionFBO) GLState::DeleteFramebuffers(1, &occlusionFBO);
+    if (occlusionTexture) GLState::DeleteTextures(1, &occlusionTexture);
+}
+
+void PostProcessor::Cleanup() {
+    ReleaseFramebuffers();
+    frameGraph.Cleanup();
+    occlusionGraph.Cleanup();
+
+    if (quadVAO) GLState::DeleteVertexArrays(1, &quadVAO);
     if (quadVBO) glDeleteBuffers(1, &quadVBO);
 
-    if (postprocessShader) glDeleteProgram(postprocessShader);
-    if (bloomExtractShader) glDeleteProgram(bloomExtractShader);
-    if (blurShader) glDeleteProgram(blurShader);
+    postprocessShader.Delete();
+    bloomExtractShader.Delete();
+    blurShader.Delete();
+    bloomDownsampleShader.Delete();
+    bloomUpsampleShader.Delete();
+    luminanceShader.Delete();
+    velocityShader.Delete();
+    taaResolveShader.Delete();
+    ssaoShader.Delete();
+    ssaoBlurShader.Delete();
+    bloomTimer.Cleanup();
+    temporalTimer.Cleanup();
+    occlusionTimer.Cleanup();
+    autoExposure.Cleanup();
 
     initialized = false;
 }
@@ -0,0 +1,120 @@
+#include "RenderTargetPool.h"
+#include "GLState.h"
+#include <iostream>
+
+RenderTargetPool::RenderTargetPool()
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    Clear();
+}
+
+int RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        if (!targets[i].acquired && targets[i].desc == desc)
+        {
+            targets[i].acquired = true;
+            targets[i].usedThisFrame = true;
+            return static_cast<int>(i);
+        }
+    }
+
+    RenderTarget target;
+    target.desc = desc;
+    target.acquired = true;
+    target.usedThisFrame = true;
+    target.idleFrames = 0;
+
+    // Only the channel count matters for storage; every pooled format is float
+    GLenum format = GL_RGBA;
+    if (desc.internalFormat == GL_R16F || desc.internalFormat == GL_R32F) format = GL_RED;
+    else if (desc.internalFormat == GL_RG16F || desc.internalFormat == GL_RG32F) format = GL_RG;
+    glGenTextures(1, &target.texture);
+    GLState::BindTexture(GL_TEXTURE_2D, target.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &target.fbo);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[RenderTargetPool] ERROR: " << desc.width << "x" << desc.height
+                  << " target framebuffer incomplete" << std::endl;
+    }
+
+    targets.push_back(target);
+    return static_cast<int>(targets.size() - 1);
+}
+
+void RenderTargetPool::Release(int index)
+{
+    targets[index].acquired = false;
+}
+
+void RenderTargetPool::EndFrame()
+{
+    for (size_t i = 0; i < targets.size(); )
+    {
+        targets[i].acquired = false;
+        targets[i].idleFrames = targets[i].usedThisFrame ? 0 : targets[i].idleFrames + 1;
+        targets[i].usedThisFrame = false;
+
+        if (targets[i].idleFrames > RELEASE_AFTER_FRAMES)
+        {
+            Delete(targets[i]);
+            targets.erase(targets.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void RenderTargetPool::Clear()
+{
+    for (RenderTarget& target : targets)
+    {
+        Delete(target);
+    }
+    targets.clear();
+}
+
+size_t RenderTargetPool::GetAllocatedBytes() const
+{
+    size_t bytes = 0;
+    for (const RenderTarget& target : targets)
+    {
+        bytes += static_cast<size_t>(target.desc.width) * target.desc.height * BytesPerPixel(target.desc.internalFormat);
+    }
+    return bytes;
+}
+
+size_t RenderTargetPool::BytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_R16F:    return 2;
+    case GL_R32F:    return 4;
+    case GL_RG16F:   return 4;
+    case GL_RG32F:   return 8;
+    case GL_RGBA16F: return 8;
+    case GL_RGBA32F: return 16;
+    default:         return 4;
+    }
+}
+
+void RenderTargetPool::Delete(RenderTarget& target)
+{
+    if (target.fbo != 0) GLState::DeleteFramebuffers(1, &target.fbo);
+    if (target.texture != 0) GLState::DeleteTextures(1, &target.texture);
+    target.fbo = target.texture = 0;
+}
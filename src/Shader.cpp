@@ -0,0 +1,294 @@
+#include "Shader.h"
+#include "GLState.h"
+#include "ShaderCache.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+std::unordered_map<std::string, unsigned int> Shader::uniformBlockBindings;
+
+Shader::Shader()
+    : ID(0)
+{
+}
+
+Shader::~Shader()
+{
+    Delete();
+}
+
+Shader::Shader(Shader&& other) noexcept
+    : ID(other.ID), label(std::move(other.label)), uniformLocations(std::move(other.uniformLocations))
+{
+    other.ID = 0;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        ID = other.ID;
+        label = std::move(other.label);
+        uniformLocations = std::move(other.uniformLocations);
+        other.ID = 0;
+    }
+    return *this;
+}
+
+std::string Shader::LoadSourceFile(const char* path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "[Shader] ERROR: Failed to read shader file: " << path << std::endl;
+        return "";
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+bool Shader::LoadFromFiles(const char* vertexPath, const char* fragmentPath)
+{
+    std::string vertexCode = LoadSourceFile(vertexPath);
+    std::string fragmentCode = LoadSourceFile(fragmentPath);
+
+    if (vertexCode.empty() || fragmentCode.empty())
+    {
+        std::cerr << "[Shader] ERROR: Failed to load shader files: " << vertexPath << " or " << fragmentPath << std::endl;
+        return false;
+    }
+
+    std::cout << "[Shader] Compiling: " << vertexPath << ", " << fragmentPath << std::endl;
+    return LoadFromSource(vertexCode.c_str(), fragmentCode.c_str(),
+                          std::string(vertexPath) + " + " + fragmentPath);
+}
+
+bool Shader::LoadFromSource(const char* vertexSource, const char* fragmentSource, const std::string& name)
+{
+    Delete();
+    label = name;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    };
+
+    // Fast path: a binary linked by a previous run with the same sources and driver
+    uint64_t cacheKey = 0;
+    if (ShaderCache::IsEnabled())
+    {
+        cacheKey = ShaderCache::ComputeKey(vertexSource, fragmentSource);
+        unsigned int cachedProgram = ShaderCache::Load(cacheKey);
+        if (cachedProgram != 0)
+        {
+            ID = cachedProgram;
+            ReflectUniforms();
+            BindUniformBlocks();
+
+            double ms = elapsedMs();
+            ShaderCache::RecordProgram(true, ms);
+            std::cout << "[Shader] Loaded " << label << " from cache (" << uniformLocations.size() << " uniforms, " << ms << " ms)" << std::endl;
+            return true;
+        }
+    }
+
+    unsigned int vertexShader = CompileStage(GL_VERTEX_SHADER, vertexSource, label);
+    unsigned int fragmentShader = CompileStage(GL_FRAGMENT_SHADER, fragmentSource, label);
+    if (vertexShader == 0 || fragmentShader == 0)
+    {
+        if (vertexShader) glDeleteShader(vertexShader);
+        if (fragmentShader) glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    if (ShaderCache::IsEnabled())
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(program);
+
+    // Shaders are no longer needed once linked (or failed to link)
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[1024];
+        glGetProgramInfoLog(program, 1024, NULL, infoLog);
+        std::cerr << "[Shader] ERROR: Program linking failed (" << label << ")\n" << infoLog << std::endl;
+        glDeleteProgram(program);
+        return false;
+    }
+
+    ID = program;
+    ReflectUniforms();
+    BindUniformBlocks();
+    ShaderCache::Store(cacheKey, program);
+
+    double ms = elapsedMs();
+    ShaderCache::RecordProgram(false, ms);
+    std::cout << "[Shader] Linked " << label << " (" << uniformLocations.size() << " uniforms, " << ms << " ms)" << std::endl;
+    return true;
+}
+
+unsigned int Shader::CompileStage(GLenum type, const char* source, const std::string& label)
+{
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[1024];
+        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+        const char* stage = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
+        std::cerr << "[Shader] ERROR: " << stage << " compilation failed (" << label << ")\n" << infoLog << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+void Shader::ReflectUniforms()
+{
+    uniformLocations.clear();
+
+    int uniformCount = 0;
+    int maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<char> nameBuffer(static_cast<size_t>(maxNameLength) + 1);
+    auto registerName = [&](const std::string& name, int location) {
+        auto result = uniformLocations.emplace(UniformId::Hash(name.c_str()), location);
+        if (!result.second && result.first->second != location)
+        {
+            std::cerr << "[Shader] WARNING: Uniform name hash collision on '" << name << "' (" << label << ")" << std::endl;
+        }
+    };
+
+    for (int i = 0; i < uniformCount; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        int location = glGetUniformLocation(ID, name.c_str());
+        if (location == -1) continue;  // Uniform block members have no location
+
+        // Arrays report "name[0]"; register the bare name and every element
+        size_t bracket = name.find("[0]");
+        if (bracket != std::string::npos && bracket + 3 == name.size())
+        {
+            std::string base = name.substr(0, bracket);
+            registerName(base, location);
+            for (GLint element = 0; element < size; ++element)
+            {
+                std::string elementName = base + "[" + std::to_string(element) + "]";
+                registerName(elementName, glGetUniformLocation(ID, elementName.c_str()));
+            }
+        }
+        else
+        {
+            registerName(name, location);
+        }
+    }
+}
+
+void Shader::SetUniformBlockBinding(const std::string& blockName, unsigned int binding)
+{
+    uniformBlockBindings[blockName] = binding;
+}
+
+void Shader::BindUniformBlocks() const
+{
+    for (const auto& entry : uniformBlockBindings)
+    {
+        GLuint blockIndex = glGetUniformBlockIndex(ID, entry.first.c_str());
+        if (blockIndex != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(ID, blockIndex, entry.second);
+        }
+    }
+}
+
+void Shader::Use() const
+{
+    GLState::UseProgram(ID);
+}
+
+void Shader::Delete()
+{
+    if (ID != 0)
+    {
+        GLState::DeleteProgram(ID);
+        ID = 0;
+    }
+    uniformLocations.clear();
+}
+
+int Shader::GetLocation(UniformId id) const
+{
+    auto it = uniformLocations.find(id.hash);
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+void Shader::SetBool(UniformId id, bool value) const
+{
+    glUniform1i(GetLocation(id), value ? 1 : 0);
+}
+
+void Shader::SetInt(UniformId id, int value) const
+{
+    glUniform1i(GetLocation(id), value);
+}
+
+void Shader::SetFloat(UniformId id, float value) const
+{
+    glUniform1f(GetLocation(id), value);
+}
+
+void Shader::SetVec2(UniformId id, const glm::vec2& value) const
+{
+    glUniform2fv(GetLocation(id), 1, glm::value_ptr(value));
+}
+
+void Shader::SetVec3(UniformId id, const glm::vec3& value) const
+{
+    glUniform3fv(GetLocation(id), 1, glm::value_ptr(value));
+}
+
+void Shader::SetVec4(UniformId id, const glm::vec4& value) const
+{
+    glUniform4fv(GetLocation(id), 1, glm::value_ptr(value));
+}
+
+void Shader::SetMat3(UniformId id, const glm::mat3& value) const
+{
+    glUniformMatrix3fv(GetLocation(id), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetMat4(UniformId id, const glm::mat4& value) const
+{
+    glUniformMatrix4fv(GetLocation(id), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetFloatArray(UniformId id, const float* values, int count) const
+{
+    glUniform1fv(GetLocation(id), count, values);
+}
@@ -0,0 +1,205 @@
+#include "ShaderCache.h"
+#include <glad/glad.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // On-disk entry header; the key is repeated to catch file name collisions
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+    };
+
+    const char CACHE_MAGIC[4] = { 'G', 'L', 'P', 'B' };
+    const uint32_t CACHE_VERSION = 1;
+
+    uint64_t Fnv1a64(const char* data, size_t length, uint64_t hash)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string GLString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+}
+
+bool ShaderCache::enabled = false;
+std::string ShaderCache::cacheDirectory;
+std::string ShaderCache::driverSignature;
+int ShaderCache::cachedPrograms = 0;
+int ShaderCache::compiledPrograms = 0;
+double ShaderCache::cachedMs = 0.0;
+double ShaderCache::compiledMs = 0.0;
+
+void ShaderCache::Initialize(const std::string& directory, bool enable)
+{
+    cacheDirectory = directory;
+    driverSignature = GLString(GL_VENDOR) + "|" + GLString(GL_RENDERER) + "|" + GLString(GL_VERSION);
+    enabled = false;
+
+    if (!enable)
+    {
+        std::cout << "[ShaderCache] Disabled (compiling all programs from source)" << std::endl;
+        return;
+    }
+
+    // Program binaries are core in 4.1; a 3.3 context may still expose them
+    GLint formatCount = 0;
+    if (GLAD_GL_VERSION_4_1 && glGetProgramBinary && glProgramBinary)
+    {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+    if (formatCount <= 0)
+    {
+        std::cout << "[ShaderCache] Program binaries not supported by this driver - cache disabled" << std::endl;
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    if (error)
+    {
+        std::cerr << "[ShaderCache] WARNING: Cannot create " << cacheDirectory << ": " << error.message() << std::endl;
+        return;
+    }
+
+    enabled = true;
+    std::cout << "[ShaderCache] Enabled (" << formatCount << " binary format(s), dir: " << cacheDirectory << ")" << std::endl;
+}
+
+uint64_t ShaderCache::ComputeKey(const char* vertexSource, const char* fragmentSource)
+{
+    uint64_t hash = 14695981039346656037ull;
+    // Separators keep ("ab", "c") and ("a", "bc") from hashing the same
+    hash = Fnv1a64(vertexSource, std::char_traits<char>::length(vertexSource) + 1, hash);
+    hash = Fnv1a64(fragmentSource, std::char_traits<char>::length(fragmentSource) + 1, hash);
+    hash = Fnv1a64(driverSignature.data(), driverSignature.size(), hash);
+    return hash;
+}
+
+std::string ShaderCache::PathForKey(uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(cacheDirectory) / name).string();
+}
+
+unsigned int ShaderCache::Load(uint64_t key)
+{
+    if (!enabled) return 0;
+
+    std::string path = PathForKey(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return 0;
+
+    CacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.key != key || header.binaryLength == 0)
+    {
+        return 0;
+    }
+
+    std::vector<char> binary(header.binaryLength);
+    file.read(binary.data(), binary.size());
+    if (!file) return 0;
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Drivers may reject binaries from an older build of themselves
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        std::cout << "[ShaderCache] Stale binary rejected by driver, recompiling: " << path << std::endl;
+        glDeleteProgram(program);
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return 0;
+    }
+
+    return program;
+}
+
+void ShaderCache::Store(uint64_t key, unsigned int program)
+{
+    if (!enabled || program == 0) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(written);
+
+    // Write to a temporary name first so a crash never leaves a torn entry
+    std::string path = PathForKey(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "[ShaderCache] WARNING: Cannot write " << tempPath << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+void ShaderCache::RecordProgram(bool fromCache, double milliseconds)
+{
+    if (fromCache)
+    {
+        cachedPrograms++;
+        cachedMs += milliseconds;
+    }
+    else
+    {
+        compiledPrograms++;
+        compiledMs += milliseconds;
+    }
+}
+
+void ShaderCache::LogStartupStats()
+{
+    std::cout << std::fixed << std::setprecision(2)
+              << "[ShaderCache] Startup: " << cachedPrograms << " program(s) from cache in " << cachedMs << " ms, "
+              << compiledPrograms << " compiled in " << compiledMs << " ms (total " << cachedMs + compiledMs << " ms)"
+              << std::defaultfloat << std::endl;
+}
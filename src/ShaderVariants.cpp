@@ -0,0 +1,115 @@
+#include "ShaderVariants.h"
+#include <algorithm>
+#include <iostream>
+
+ShaderVariants::ShaderVariants()
+    : supportedFeatures(0)
+{
+}
+
+bool ShaderVariants::Load(const char* vertexFile, const char* fragmentFile,
+                          const std::vector<std::string>& defines, SetupFn setupFn)
+{
+    Clear();
+
+    vertexPath = vertexFile;
+    fragmentPath = fragmentFile;
+    vertexSource = Shader::LoadSourceFile(vertexFile);
+    fragmentSource = Shader::LoadSourceFile(fragmentFile);
+    featureDefines = defines;
+    setup = std::move(setupFn);
+
+    supportedFeatures = 0;
+    for (size_t i = 0; i < featureDefines.size() && i < 32; ++i)
+    {
+        if (!featureDefines[i].empty())
+        {
+            supportedFeatures |= 1u << i;
+        }
+    }
+
+    if (vertexSource.empty() || fragmentSource.empty())
+    {
+        std::cerr << "[ShaderVariants] ERROR: Failed to load shader files: " << vertexPath << " or " << fragmentPath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const Shader& ShaderVariants::Get(uint32_t features)
+{
+    features &= supportedFeatures;
+
+    auto it = variants.find(features);
+    if (it != variants.end())
+    {
+        return it->second;
+    }
+
+    std::vector<std::string> defines;
+    std::string suffix;
+    for (size_t i = 0; i < featureDefines.size(); ++i)
+    {
+        if (features & (1u << i))
+        {
+            defines.push_back(featureDefines[i]);
+            suffix += (suffix.empty() ? "" : " ") + featureDefines[i];
+        }
+    }
+
+    std::string label = vertexPath + " + " + fragmentPath + " [" + (suffix.empty() ? "base" : suffix) + "]";
+    std::cout << "[ShaderVariants] Compiling variant: " << label << std::endl;
+
+    Shader& shader = variants[features];
+    if (!vertexSource.empty() && !fragmentSource.empty())
+    {
+        std::string vertexCode = InjectDefines(vertexSource, defines);
+        std::string fragmentCode = InjectDefines(fragmentSource, defines);
+        if (shader.LoadFromSource(vertexCode.c_str(), fragmentCode.c_str(), label) && setup)
+        {
+            shader.Use();
+            setup(shader);
+        }
+    }
+
+    if (!shader.IsValid())
+    {
+        std::cerr << "[ShaderVariants] ERROR: Variant unavailable: " << label << std::endl;
+    }
+
+    return shader;
+}
+
+void ShaderVariants::Clear()
+{
+    // Shader destructors delete the programs
+    variants.clear();
+}
+
+std::string ShaderVariants::InjectDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+    // #version must stay the first directive; everything else goes after it
+    size_t versionPos = source.find("#version");
+    size_t bodyStart = 0;
+    std::string header;
+    if (versionPos != std::string::npos)
+    {
+        size_t lineEnd = source.find('\n', versionPos);
+        bodyStart = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+        header = source.substr(0, bodyStart);
+        if (header.back() != '\n') header += '\n';
+    }
+
+    std::string result = header;
+    for (const std::string& define : defines)
+    {
+        result += "#define " + define + "\n";
+    }
+
+    // Resume numbering at the first line after #version
+    int bodyLine = 1 + static_cast<int>(std::count(source.begin(), source.begin() + bodyStart, '\n'));
+    result += "#line " + std::to_string(bodyLine) + "\n";
+    result += source.substr(bodyStart);
+    return result;
+}
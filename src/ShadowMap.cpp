@@ -1,24 +1,117 @@
 #include "ShadowMap.h"
+#include "GLState.h"
+#include "Camera.h"
+#include "PostProcessor.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-ShadowMap::ShadowMap(unsigned int width, unsigned int height)
-    : m_Width(width), m_Height(height), m_FBO(0), m_DepthTexture(0), m_PreviousFBO(0)
+namespace
 {
+    // Matches Camera::GetProjectionMatrix defaults
+    const float CAMERA_NEAR = 0.1f;
+    
+    // Depth slack above the highest caster when the scene bounds are known
+    const float SCENE_DEPTH_MARGIN = 1.0f;
+}
+
+ShadowMap::ShadowMap(unsigned int resolution, int cascadeCount)
+    : m_FBO(0), m_DepthTexture(0), m_StaticFBO(0), m_StaticTexture(0), m_RawSampler(0), m_Resolution(resolution),
+      m_CascadeCount(std::clamp(cascadeCount, MIN_CASCADES, MAX_CASCADES)), m_PreviousFBO(0),
+      m_SplitLambda(0.75f), m_ShadowDistance(100.0f), m_CasterMargin(50.0f), m_CachePadding(0.15f),
+      m_LightDirection(0.0f), m_LightView(1.0f), m_FrameIndex(0),
+      m_HasSceneBounds(false), m_SceneMin(0.0f), m_SceneMax(0.0f),
+      m_MomentTexture(0), m_MomentFBO(0), m_MomentScratchTexture(0), m_MomentScratchFBO(0),
+      m_MomentBlurTexture(0), m_MomentBlurFBO(0), m_MomentsInitialized(false)
+{
+    for (int i = 0; i < MAX_CASCADES; ++i)
+    {
+        m_SplitDistances[i] = 0.0f;
+        m_LightSpaceMatrices[i] = glm::mat4(1.0f);
+        m_BoundsMin[i] = glm::vec3(0.0f);
+        m_BoundsMax[i] = glm::vec3(0.0f);
+        m_TexelSizes[i] = glm::vec2(0.0f);
+        m_StaticValid[i] = false;
+        m_CascadeLightDirections[i] = glm::vec3(0.0f);
+        m_UpdateIntervals[i] = 1;
+        m_CascadeDue[i] = false;
+        m_CascadeFitted[i] = false;
+        m_MomentValid[i] = false;
+    }
     Init();
 }
 
 ShadowMap::~ShadowMap()
+{
+    Cleanup();
+}
+
+void ShadowMap::Cleanup()
+{
+    Release();
+    m_MomentShader.Delete();
+    m_MomentsInitialized = false;
+}
+
+void ShadowMap::Release()
 {
     if (m_DepthTexture != 0)
     {
-        glDeleteTextures(1, &m_DepthTexture);
+        GLState::DeleteTextures(1, &m_DepthTexture);
         m_DepthTexture = 0;
     }
     
     if (m_FBO != 0)
     {
-        glDeleteFramebuffers(1, &m_FBO);
+        GLState::DeleteFramebuffers(1, &m_FBO);
         m_FBO = 0;
     }
+    
+    if (m_StaticTexture != 0)
+    {
+        GLState::DeleteTextures(1, &m_StaticTexture);
+        m_StaticTexture = 0;
+    }
+    
+    if (m_StaticFBO != 0)
+    {
+        GLState::DeleteFramebuffers(1, &m_StaticFBO);
+        m_StaticFBO = 0;
+    }
+    
+    if (m_RawSampler != 0)
+    {
+        GLState::DeleteSamplers(1, &m_RawSampler);
+        m_RawSampler = 0;
+    }
+    
+    unsigned int momentTextures[] = { m_MomentTexture, m_MomentScratchTexture, m_MomentBlurTexture };
+    unsigned int momentFBOs[] = { m_MomentFBO, m_MomentScratchFBO, m_MomentBlurFBO };
+    if (m_MomentTexture != 0)
+    {
+        GLState::DeleteTextures(3, momentTextures);
+        GLState::DeleteFramebuffers(3, momentFBOs);
+        m_MomentTexture = m_MomentScratchTexture = m_MomentBlurTexture = 0;
+        m_MomentFBO = m_MomentScratchFBO = m_MomentBlurFBO = 0;
+    }
+}
+
+void ShadowMap::SetResolution(unsigned int resolution)
+{
+    if (resolution == m_Resolution || resolution == 0) return;
+    
+    Release();
+    m_Resolution = resolution;
+    Init();
+    
+    // Texel snapping and every cached layer depend on the resolution
+    for (int i = 0; i < MAX_CASCADES; ++i)
+    {
+        m_CascadeFitted[i] = false;
+        m_StaticValid[i] = false;
+        m_MomentValid[i] = false;
+    }
 }
 
 void ShadowMap::Init()
@@ -26,24 +119,37 @@ void ShadowMap::Init()
     // Create framebuffer
     glGenFramebuffers(1, &m_FBO);
     
-    // Create depth texture
+    // Create depth texture array (one layer per cascade)
     glGenTextures(1, &m_DepthTexture);
-    glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_Width, m_Height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_DepthTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, m_Resolution, m_Resolution, m_CascadeCount,
+                 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
     
-    // Texture parameters for shadow sampling
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    // Hardware PCF: depth compare + linear filtering makes every shadow
+    // sampler fetch return the bilinear-weighted result of four compares
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     
     // Border color (white = no shadow outside frustum)
     float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    
+    // Plain depth reads (debug view, reference PCF loop) go through a sampler object
+    glGenSamplers(1, &m_RawSampler);
+    glSamplerParameteri(m_RawSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glSamplerParameteri(m_RawSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glSamplerParameteri(m_RawSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+    glSamplerParameteri(m_RawSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glSamplerParameteri(m_RawSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glSamplerParameterfv(m_RawSampler, GL_TEXTURE_BORDER_COLOR, borderColor);
     
-    // Attach depth texture to framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_DepthTexture, 0);
+    // Attach the first layer to check completeness; BindForWriting switches layers
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_DepthTexture, 0, 0);
     
     // No color attachment
     glDrawBuffer(GL_NONE);
@@ -55,29 +161,367 @@ void ShadowMap::Init()
         std::cerr << "ERROR: Shadow map framebuffer is not complete!" << std::endl;
     }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Static cache: same format so layers can be blitted; never sampled
+    glGenTextures(1, &m_StaticTexture);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_StaticTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, m_Resolution, m_Resolution, m_CascadeCount,
+                 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    glGenFramebuffers(1, &m_StaticFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_StaticFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_StaticTexture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "ERROR: Static shadow cache framebuffer is not complete!" << std::endl;
+    }
+    
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
     
-    std::cout << "Shadow map created: " << m_Width << "x" << m_Height << std::endl;
+    std::cout << "Shadow map created: " << m_CascadeCount << " cascades of "
+              << m_Resolution << "x" << m_Resolution << std::endl;
 }
 
-void ShadowMap::BindForWriting()
+void ShadowMap::Update(const Camera& camera, float aspectRatio, const glm::vec3& lightDirection)
 {
-    // Save current framebuffer
-    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_PreviousFBO);
+    // Practical split scheme: blend logarithmic and uniform partitions
+    const float nearPlane = CAMERA_NEAR;
+    const float farPlane = m_ShadowDistance;
+    for (int i = 0; i < m_CascadeCount; ++i)
+    {
+        float p = static_cast<float>(i + 1) / static_cast<float>(m_CascadeCount);
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, p);
+        float uniformSplit = nearPlane + (farPlane - nearPlane) * p;
+        m_SplitDistances[i] = m_SplitLambda * logSplit + (1.0f - m_SplitLambda) * uniformSplit;
+    }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, m_Width, m_Height);
+    if (lightDirection != m_LightDirection)
+    {
+        m_LightDirection = lightDirection;
+        glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        m_LightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+    }
+    
+    // Scene bounds in light space: receivers outside them do not exist and
+    // every caster lies inside, which bounds both the footprint and the depth range
+    glm::vec3 sceneMin(std::numeric_limits<float>::lowest());
+    glm::vec3 sceneMax(std::numeric_limits<float>::max());
+    if (m_HasSceneBounds)
+    {
+        sceneMin = glm::vec3(std::numeric_limits<float>::max());
+        sceneMax = glm::vec3(std::numeric_limits<float>::lowest());
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 world((corner & 1) ? m_SceneMax.x : m_SceneMin.x,
+                            (corner & 2) ? m_SceneMax.y : m_SceneMin.y,
+                            (corner & 4) ? m_SceneMax.z : m_SceneMin.z);
+            glm::vec3 lightSpace = glm::vec3(m_LightView * glm::vec4(world, 1.0f));
+            sceneMin = glm::min(sceneMin, lightSpace);
+            sceneMax = glm::max(sceneMax, lightSpace);
+        }
+    }
+    
+    glm::mat4 view = camera.GetViewMatrix();
+    float sliceNear = nearPlane;
+    for (int i = 0; i < m_CascadeCount; ++i)
+    {
+        glm::mat4 sliceProjection = camera.GetProjectionMatrix(aspectRatio, sliceNear, m_SplitDistances[i]);
+        sliceNear = m_SplitDistances[i];
+    
+        // Offsetting by the cascade index staggers cascades with equal intervals
+        int interval = m_UpdateIntervals[i];
+        m_CascadeDue[i] = !m_CascadeFitted[i] || interval <= 1 || (m_FrameIndex + i) % interval == 0;
+        if (!m_CascadeDue[i])
+        {
+            continue;
+        }
+        m_CascadeFitted[i] = true;
+    
+        // A cascade fitted for another light direction has a stale box and cache
+        if (m_CascadeLightDirections[i] != m_LightDirection)
+        {
+            m_CascadeLightDirections[i] = m_LightDirection;
+            m_StaticValid[i] = false;
+        }
+    
+        // Frustum slice intersected with the scene bounds
+        glm::vec3 sliceMin, sliceMax;
+        float sliceRadius;
+        SliceBounds(glm::inverse(sliceProjection * view), sliceMin, sliceMax, sliceRadius);
+        sliceMin = glm::min(glm::max(sliceMin, sceneMin), sceneMax);
+        sliceMax = glm::max(glm::min(sliceMax, sceneMax), sliceMin);
+    
+        // Keep the cached box (and its static layer) while the slice still fits;
+        // snapping can cost up to a texel at the scene edge, so allow that much
+        glm::vec3 slack(m_TexelSizes[i].x, m_TexelSizes[i].y, 0.0f);
+        glm::vec3 boxMin = m_BoundsMin[i] - slack;
+        glm::vec3 boxMax = m_BoundsMax[i] + slack;
+        bool contained = sliceMin.x >= boxMin.x && sliceMin.y >= boxMin.y && sliceMin.z >= boxMin.z &&
+                         sliceMax.x <= boxMax.x && sliceMax.y <= boxMax.y && sliceMax.z <= boxMax.z;
+        if (m_StaticValid[i] && contained)
+        {
+            continue;
+        }
+        m_StaticValid[i] = false;
+    
+        // Footprint from the slice's bounding sphere (rounded up) so it does not
+        // change as the camera turns; never larger than the scene itself
+        float diameter = 2.0f * std::ceil(sliceRadius * 16.0f) / 16.0f;
+        float footprint = diameter * (1.0f + 2.0f * m_CachePadding);
+        glm::vec2 size(std::min(footprint, sceneMax.x - sceneMin.x), std::min(footprint, sceneMax.y - sceneMin.y));
+        size = glm::max(size, glm::vec2(1.0f));
+    
+        // Centre on the slice, keep inside the scene, then snap the origin to
+        // whole texels: a refit moves the map by whole texels and never shimmers
+        glm::vec2 texel = size / static_cast<float>(m_Resolution);
+        glm::vec2 origin = glm::vec2(sliceMin + sliceMax) * 0.5f - size * 0.5f;
+        origin = glm::max(glm::min(origin, glm::vec2(sceneMax) - size), glm::vec2(sceneMin));
+        origin = glm::floor(origin / texel) * texel;
+        m_TexelSizes[i] = texel;
+    
+        // Depth: receivers down to the padded slice bottom, casters up to the
+        // top of the scene (or a fixed margin toward the light without bounds)
+        float depthPadding = (sliceMax.z - sliceMin.z) * m_CachePadding;
+        m_BoundsMin[i] = glm::vec3(origin, std::max(sliceMin.z - depthPadding, sceneMin.z));
+        m_BoundsMax[i] = glm::vec3(origin + size, m_HasSceneBounds ? sceneMax.z : sliceMax.z + depthPadding);
+        float casterMargin = m_HasSceneBounds ? SCENE_DEPTH_MARGIN : m_CasterMargin;
+    
+        // The light looks down -Z: near is -maxZ, far is -minZ
+        glm::mat4 lightProjection = glm::ortho(m_BoundsMin[i].x, m_BoundsMax[i].x, m_BoundsMin[i].y, m_BoundsMax[i].y,
+                                               -m_BoundsMax[i].z - casterMargin, -m_BoundsMin[i].z);
+        m_LightSpaceMatrices[i] = lightProjection * m_LightView;
+    }
+    m_FrameIndex++;
+}
+
+void ShadowMap::SetSceneBounds(const glm::vec3& minBounds, const glm::vec3& maxBounds)
+{
+    if (m_HasSceneBounds && minBounds == m_SceneMin && maxBounds == m_SceneMax) return;
+    
+    // Every cascade box is clipped against these
+    m_SceneMin = minBounds;
+    m_SceneMax = maxBounds;
+    m_HasSceneBounds = true;
+    InvalidateStatic();
+}
+
+void ShadowMap::SliceBounds(const glm::mat4& inverseViewProjection, glm::vec3& minBounds, glm::vec3& maxBounds, float& radius) const
+{
+    // World-space corners of the frustum slice
+    glm::vec3 corners[8];
+    glm::vec3 center(0.0f);
+    int index = 0;
+    for (int x = 0; x < 2; ++x)
+    {
+        for (int y = 0; y < 2; ++y)
+        {
+            for (int z = 0; z < 2; ++z)
+            {
+                glm::vec4 corner = inverseViewProjection * glm::vec4(x * 2.0f - 1.0f, y * 2.0f - 1.0f, z * 2.0f - 1.0f, 1.0f);
+                corners[index] = glm::vec3(corner) / corner.w;
+                center += corners[index];
+                index++;
+            }
+        }
+    }
+    center /= 8.0f;
+    
+    // Light-space bounds, plus the bounding sphere radius (rotation invariant)
+    minBounds = glm::vec3(std::numeric_limits<float>::max());
+    maxBounds = glm::vec3(std::numeric_limits<float>::lowest());
+    radius = 0.0f;
+    for (const glm::vec3& corner : corners)
+    {
+        radius = std::max(radius, glm::length(corner - center));
+        glm::vec3 lightSpaceCorner = glm::vec3(m_LightView * glm::vec4(corner, 1.0f));
+        minBounds = glm::min(minBounds, lightSpaceCorner);
+        maxBounds = glm::max(maxBounds, lightSpaceCorner);
+    }
+}
+
+void ShadowMap::InvalidateStatic()
+{
+    for (int i = 0; i < MAX_CASCADES; ++i)
+    {
+        m_StaticValid[i] = false;
+    }
+}
+
+void ShadowMap::BindStaticForWriting(int cascade)
+{
+    if (GLState::GetDrawFramebuffer() != m_FBO && GLState::GetDrawFramebuffer() != m_StaticFBO)
+    {
+        m_PreviousFBO = static_cast<GLint>(GLState::GetDrawFramebuffer());
+    }
+    
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_StaticFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_StaticTexture, 0, cascade);
+    GLState::Viewport(0, 0, m_Resolution, m_Resolution);
     glClear(GL_DEPTH_BUFFER_BIT);
+    
+    // The caller draws the static casters right after this
+    m_StaticValid[cascade] = true;
 }
 
-void ShadowMap::BindForReading(GLenum textureUnit)
+void ShadowMap::BindForWriting(int cascade)
 {
-    glActiveTexture(textureUnit);
-    glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
+    // Save current framebuffer once per pass (from the state tracker)
+    if (GLState::GetDrawFramebuffer() != m_FBO && GLState::GetDrawFramebuffer() != m_StaticFBO)
+    {
+        m_PreviousFBO = static_cast<GLint>(GLState::GetDrawFramebuffer());
+    }
+    
+    // Start from the cached static depth; dynamic casters depth-test against it (min composite)
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_StaticFBO);
+    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_StaticTexture, 0, cascade);
+    GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_FBO);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_DepthTexture, 0, cascade);
+    GLState::DepthMask(GL_TRUE);
+    glBlitFramebuffer(0, 0, m_Resolution, m_Resolution, 0, 0, m_Resolution, m_Resolution,
+                      GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    GLState::Viewport(0, 0, m_Resolution, m_Resolution);
+}
+
+void ShadowMap::BindForReading(GLenum textureUnit, bool rawDepth)
+{
+    GLState::ActiveTexture(textureUnit);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_DepthTexture);
+    GLState::BindSampler(textureUnit - GL_TEXTURE0, rawDepth ? m_RawSampler : 0);
 }
 
 void ShadowMap::Unbind()
 {
     // Restore previous framebuffer (HDR FBO or screen FBO)
-    glBindFramebuffer(GL_FRAMEBUFFER, m_PreviousFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_PreviousFBO);
+}
+
+bool ShadowMap::InitMoments()
+{
+    // The program is loaded once; a resize only reallocates the textures below
+    if (!m_MomentsInitialized)
+    {
+        m_MomentsInitialized = true;
+        m_MomentShader.LoadFromFiles("shaders/postprocess.vert", "shaders/shadow_moments.frag");
+        if (!m_MomentShader.IsValid())
+        {
+            std::cerr << "ERROR: Shadow moment shader failed to load, EVSM unavailable" << std::endl;
+            return false;
+        }
+        m_MomentShader.Use();
+        m_MomentShader.SetInt("depthMap", 0);
+    }
+    if (!m_MomentShader.IsValid()) return false;
+    if (m_MomentTexture != 0) return true;
+    
+    // Moment array: filtered with mips (this is what makes one fetch enough)
+    int mipLevels = 1;
+    while ((m_Resolution >> mipLevels) > 0) mipLevels++;
+    glGenTextures(1, &m_MomentTexture);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_MomentTexture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, mipLevels - 1);
+    for (int level = 0; level < mipLevels; ++level)
+    {
+        unsigned int size = std::max(m_Resolution >> level, 1u);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA32F, size, size, m_CascadeCount, 0, GL_RGBA, GL_FLOAT, NULL);
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    glGenFramebuffers(1, &m_MomentFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_MomentFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_MomentTexture, 0, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    
+    // Single-layer 2D targets for the conversion and the horizontal blur
+    unsigned int* textures[] = { &m_MomentScratchTexture, &m_MomentBlurTexture };
+    unsigned int* fbos[] = { &m_MomentScratchFBO, &m_MomentBlurFBO };
+    for (int i = 0; i < 2; ++i)
+    {
+        glGenTextures(1, textures[i]);
+        GLState::BindTexture(GL_TEXTURE_2D, *textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, m_Resolution, m_Resolution, 0, GL_RGBA, GL_FLOAT, NULL);
+        // Linear: the blur's paired taps rely on bilinear filtering between texels
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        
+        glGenFramebuffers(1, fbos[i]);
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, *fbos[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *textures[i], 0);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    
+    if (!complete)
+    {
+        std::cerr << "ERROR: Shadow moment framebuffers are not complete!" << std::endl;
+    }
+    
+    std::cout << "Shadow moments created: " << m_CascadeCount << " x " << m_Resolution << "x" << m_Resolution
+              << " RGBA32F, " << mipLevels << " mips" << std::endl;
+    return true;
+}
+
+bool ShadowMap::UpdateMoments(PostProcessor& blur)
+{
+    if (!InitMoments()) return false;
+    
+    GLState::Disable(GL_DEPTH_TEST);
+    bool updated = false;
+    for (int i = 0; i < m_CascadeCount; ++i)
+    {
+        // Layers that were not re-rendered keep their moments
+        if (!m_CascadeDue[i] && m_MomentValid[i]) continue;
+        
+        // Depth -> warped moments
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, m_MomentScratchFBO);
+        GLState::Viewport(0, 0, m_Resolution, m_Resolution);
+        m_MomentShader.Use();
+        m_MomentShader.SetInt("cascade", i);
+        BindForReading(GL_TEXTURE0, true);
+        blur.RenderScreenQuad();
+        GLState::BindSampler(0, 0);
+        
+        // Prefilter once per update instead of per fragment: horizontal into
+        // the blur target, vertical into this cascade's layer
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, m_MomentFBO);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_MomentTexture, 0, i);
+        blur.SeparableBlur(m_MomentScratchTexture, m_MomentBlurFBO, m_MomentBlurTexture,
+                           m_MomentFBO, m_Resolution, m_Resolution);
+        
+        m_MomentValid[i] = true;
+        updated = true;
+    }
+    
+    if (updated)
+    {
+        GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_MomentTexture);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+    GLState::Enable(GL_DEPTH_TEST);
+    return true;
+}
+
+void ShadowMap::InvalidateMoments()
+{
+    for (int i = 0; i < MAX_CASCADES; ++i)
+    {
+        m_MomentValid[i] = false;
+    }
+}
+
+void ShadowMap::BindMomentsForReading(GLenum textureUnit)
+{
+    GLState::ActiveTexture(textureUnit);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_MomentTexture);
+    GLState::BindSampler(textureUnit - GL_TEXTURE0, 0);
 }
@@ -1,4 +1,5 @@
 #include "Skybox.h"
+#include "GLState.h"
 #include <iostream>
 
 Skybox::Skybox() : VAO(0), VBO(0)
@@ -57,14 +58,14 @@ void Skybox::setupSkybox()
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
 
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
 bool Skybox::Load(const std::string& directory, const std::string faces[6])
@@ -93,20 +94,19 @@ bool Skybox::LoadFromPaths(const std::string paths[6])
 
 void Skybox::Draw(unsigned int shaderProgram)
 {
-    glDepthFunc(GL_LEQUAL);  // Change depth function so skybox renders behind everything
-    glUseProgram(shaderProgram);
+    GLState::DepthFunc(GL_LEQUAL);  // Change depth function so skybox renders behind everything
+    GLState::UseProgram(shaderProgram);
 
     cubemapTexture.Bind(0);
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
 
-    glDepthFunc(GL_LESS);  // Set depth function back to default
+    GLState::DepthFunc(GL_LESS);  // Set depth function back to default
 }
 
 void Skybox::Delete()
 {
-    glDeleteVertexArrays(1, &VAO);
+    GLState::DeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     cubemapTexture.Delete();
 }
@@ -1,4 +1,5 @@
 #include "SkyboxAtlas.h"
+#include "GLState.h"
 #include <stb_image.h>
 #include <iostream>
 #include <filesystem>
@@ -80,7 +81,7 @@ void SkyboxAtlas::SetupGeometry()
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     
@@ -93,7 +94,7 @@ void SkyboxAtlas::SetupGeometry()
     glEnableVertexAttribArray(1);
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
     
     std::cout << "[SkyboxAtlas] Geometry initialized" << std::endl;
 }
@@ -125,7 +126,7 @@ unsigned int SkyboxAtlas::LoadAtlasTexture(const char* path)
         else if (nrChannels == 4)
             format = GL_RGBA;
         
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLState::BindTexture(GL_TEXTURE_2D, textureID);
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         
         // CRITICAL: GL_CLAMP_TO_EDGE prevents seam bleeding in atlas
@@ -155,7 +156,7 @@ unsigned int SkyboxAtlas::LoadAtlasTexture(const char* path)
         std::cout << "[SkyboxAtlas]   STB Error: " << (reason ? reason : "Unknown") << std::endl;
         
         stbi_image_free(data);
-        glDeleteTextures(1, &textureID);
+        GLState::DeleteTextures(1, &textureID);
         return 0; // Return 0 on failure
     }
 }
@@ -227,7 +228,7 @@ bool SkyboxAtlas::LoadFromAtlas(const char* primaryPath)
     }
     
     glGenTextures(1, &atlasTextureID);
-    glBindTexture(GL_TEXTURE_2D, atlasTextureID);
+    GLState::BindTexture(GL_TEXTURE_2D, atlasTextureID);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, fallback);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -244,25 +245,24 @@ void SkyboxAtlas::Draw(unsigned int shaderProgram) const
 {
     if (!initialized) return;
     
-    glDepthFunc(GL_LEQUAL);
-    glUseProgram(shaderProgram);
+    GLState::DepthFunc(GL_LEQUAL);
+    GLState::UseProgram(shaderProgram);
     
-    glBindVertexArray(VAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, atlasTextureID);
+    GLState::BindVertexArray(VAO);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, atlasTextureID);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
     
-    glDepthFunc(GL_LESS);
+    GLState::DepthFunc(GL_LESS);
 }
 
 void SkyboxAtlas::Cleanup()
 {
     if (initialized)
     {
-        glDeleteVertexArrays(1, &VAO);
+        GLState::DeleteVertexArrays(1, &VAO);
         glDeleteBuffers(1, &VBO);
-        glDeleteTextures(1, &atlasTextureID);
+        GLState::DeleteTextures(1, &atlasTextureID);
         
         VAO = 0;
         VBO = 0;
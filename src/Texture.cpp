@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "GLState.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <iostream>
@@ -109,7 +110,7 @@ bool Texture::LoadFromFile(const std::string& path, bool flipVertically)
 
     // Generate texture
     glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLState::BindTexture(GL_TEXTURE_2D, ID);
 
     // Set texture wrapping parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -154,7 +155,7 @@ bool Texture::LoadCubemap(const std::string faces[6])
     isCubemap = true;
 
     glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
+    GLState::BindTexture(GL_TEXTURE_CUBE_MAP, ID);
 
     const char* faceNames[6] = { "right", "left", "top", "bottom", "front", "back" };
     const char* extensions[3] = { ".jpg", ".png", ".jpeg" };
@@ -366,26 +367,26 @@ bool Texture::LoadSkyboxAuto(const std::string& skyboxDirectory, Texture& cubema
 
 void Texture::Bind(unsigned int slot) const
 {
-    glActiveTexture(GL_TEXTURE0 + slot);
+    GLState::ActiveTexture(GL_TEXTURE0 + slot);
     if (isCubemap)
-        glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
+        GLState::BindTexture(GL_TEXTURE_CUBE_MAP, ID);
     else
-        glBindTexture(GL_TEXTURE_2D, ID);
+        GLState::BindTexture(GL_TEXTURE_2D, ID);
 }
 
 void Texture::Unbind() const
 {
     if (isCubemap)
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        GLState::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     else
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLState::BindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Texture::Delete()
 {
     if (ID != 0)
     {
-        glDeleteTextures(1, &ID);
+        GLState::DeleteTextures(1, &ID);
         ID = 0;
     }
 }
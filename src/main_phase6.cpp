@@ -10,15 +10,24 @@
 #include <sstream>
 #include <string>
 #include <filesystem>
+#include <cmath>
 
 // Phase 2 + 3 + 4 + 5 + 6 includes
 #include "Camera.h"
+#include "Shader.h"
+#include "GLState.h"
+#include "FrameUniforms.h"
+#include "ShaderCache.h"
+#include "ShaderVariants.h"
 #include "Model.h"
 #include "Skybox.h"
 #include "ShadowMap.h"
+#include "GpuTimer.h"
+#include "FrameGovernor.h"
 #include "HUD.h"
 #include "PostProcessor.h"
 #include "City.h"
+#include "CityBenchmark.h"
 #include "SkyboxAtlas.h"
 
 // Window dimensions
@@ -26,8 +35,10 @@ const unsigned int SCR_WIDTH = 1920;  // Increased from 800 to 1920 (Full HD wid
 const unsigned int SCR_HEIGHT = 1080; // Increased from 600 to 1080 (Full HD height)
 
 // Shadow map resolution
-const unsigned int SHADOW_WIDTH = 2048;
-const unsigned int SHADOW_HEIGHT = 2048;
+// Shadow cascades: 3 x 1024^2 covers the whole view distance with fewer
+// texels than the old single 2048^2 map
+const unsigned int SHADOW_RESOLUTION = 1024;
+const int SHADOW_CASCADE_COUNT = 3;
 
 // FPS counter variables
 double lastTime = 0.0;
@@ -36,10 +47,53 @@ int currentFPS = 0;
 
 // Phase 3 toggles
 bool enableShadows = true;
-bool enablePCF = true;
+
+// Shadow filtering (F2 cycles): hard, PCF (kernel picked with F10) or prefiltered EVSM
+enum ShadowMode
+{
+    SHADOW_MODE_HARD,
+    SHADOW_MODE_PCF,
+    SHADOW_MODE_EVSM,
+    SHADOW_MODE_COUNT
+};
+const char* SHADOW_MODE_NAMES[SHADOW_MODE_COUNT] = { "Hard", "PCF", "EVSM" };
+int shadowMode = SHADOW_MODE_PCF;
 bool showDepthMap = false;
 bool enableGammaCorrection = false;
 
+// Scene shader permutation bits (F1/F2/F4/F10 pick the compiled variant)
+enum SceneFeature : uint32_t
+{
+    FEATURE_SHADOWS   = 1u << 0,
+    FEATURE_PCF       = 1u << 1,
+    FEATURE_GAMMA     = 1u << 2,
+    FEATURE_PCF_TAPS_4  = 1u << 3,
+    FEATURE_PCF_TAPS_9  = 1u << 4,
+    FEATURE_PCF_TAPS_16 = 1u << 5,
+    FEATURE_PCF_POISSON = 1u << 6,
+    FEATURE_PCF_LEGACY  = 1u << 7,
+    FEATURE_EVSM        = 1u << 8,
+    FEATURE_AMBIENT_OCCLUSION = 1u << 9
+};
+
+// PCF kernels (F10 cycles). Hardware taps use the depth-compare sampler; the
+// legacy 49-fetch loop stays available as the GPU-time reference.
+enum ShadowFilter
+{
+    SHADOW_FILTER_1_TAP,
+    SHADOW_FILTER_4_TAP,
+    SHADOW_FILTER_9_TAP,
+    SHADOW_FILTER_16_TAP,
+    SHADOW_FILTER_16_POISSON,
+    SHADOW_FILTER_LEGACY_49,
+    SHADOW_FILTER_COUNT
+};
+const char* SHADOW_FILTER_NAMES[SHADOW_FILTER_COUNT] = {
+    "HW 1-tap", "HW 4-tap", "HW 9-tap", "HW 16-tap", "HW 16-tap Poisson", "Legacy 49-fetch"
+};
+const int SHADOW_FILTER_TAPS[SHADOW_FILTER_COUNT] = { 1, 4, 9, 16, 16, 49 };
+int shadowFilter = SHADOW_FILTER_16_TAP;
+
 // Phase 4 additions
 bool mouseCaptured = true;
 bool animationPaused = false;
@@ -55,13 +109,39 @@ const float BLOOM_STRENGTH_STEP = 0.05f;
 float bloomThreshold = 1.0f;
 const float THRESHOLD_STEP = 0.1f;
 int debugViewMode = 0; // 0=normal, 1=HDR only, 2=bright pass, 3=bloom blur
+BloomMode bloomMode = BLOOM_DUAL_FILTER;  // L toggles (the post-processor logs the GPU time of each)
+bool enableAutoExposure = false;  // X toggles; exposure (+/-) then acts as compensation
+// U cycles: off, then temporal upsampling from each of these render scales
+const float TEMPORAL_SCALES[] = {1.0f, 0.75f, 0.5f};
+const int TEMPORAL_SCALE_COUNT = sizeof(TEMPORAL_SCALES) / sizeof(TEMPORAL_SCALES[0]);
+int temporalMode = 0;  // 0 = off, n = TEMPORAL_SCALES[n - 1]
+unsigned int temporalFrame = 0;  // Position in the camera's jitter sequence
+bool enableAmbientOcclusion = false;  // H toggles SSAO (adds a depth prepass)
 
 // Phase 6 additions
 bool enableCity = true;
+bool enableCityCulling = true;
 bool useSkyboxAtlas = false; // DEFAULT TO CUBEMAP for final demo (most robust)
 bool cPressed = false;
 bool kPressed = false;
 
+// Shadow refresh schedule: N animates the sun, M refreshes cascades round-robin
+bool animateSun = false;
+bool amortizeShadows = false;
+const float SUN_SPEED = 10.0f;  // Azimuth degrees per second
+const int SHADOW_UPDATE_INTERVALS[ShadowMap::MAX_CASCADES] = { 1, 2, 4, 4 };  // Frames between refreshes
+bool nPressed = false;
+bool mPressed = false;
+
+// Frame-time governor (F11): trades render scale, PCF kernel, bloom levels and
+// shadow resolution for GPU time; F12 cycles the target
+bool enableGovernor = false;
+const float GOVERNOR_TARGETS_MS[] = { 16.7f, 33.3f, 11.1f, 8.3f };  // 60, 30, 90, 120 Hz
+const int GOVERNOR_TARGET_COUNT = 4;
+int governorTarget = 0;
+bool f11Pressed = false;
+bool f12Pressed = false;
+
 // Key press tracking
 bool f1Pressed = false;
 bool f2Pressed = false;
@@ -71,7 +151,13 @@ bool f5Pressed = false;
 bool f6Pressed = false;
 bool f7Pressed = false;
 bool f8Pressed = false;
+bool f9Pressed = false;
+bool f10Pressed = false;
 bool bPressed = false;
+bool lPressed = false;
+bool xPressed = false;
+bool uPressed = false;
+bool hPressed = false;
 bool oPressed = false;
 bool vPressed = false;  // Changed from dPressed to vPressed
 bool tPressed = false;
@@ -102,12 +188,12 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window, Camera& camera, float deltaTime);
 void processDebugKeys(GLFWwindow* window, SkyboxAtlas* skyboxAtlas);
 void processLightControls(GLFWwindow* window);
-std::string loadShaderFromFile(const char* filePath);
-unsigned int compileShader(unsigned int type, const char* source);
-unsigned int createShaderProgram(const char* vertexPath, const char* fragmentPath);
+uint32_t shadowFilterFeatures(int filter);
+int governedShadowFilter(int filter, int maxTaps);
+void bindSceneShadows(ShadowMap& shadowMap, uint32_t sceneFeatures);
 void updateFPS(GLFWwindow* window);
 void renderQuad();
-void renderGroundPlane(unsigned int shader, const glm::mat4& model);
+void renderGroundPlane(const Shader& shader, const glm::mat4& model);
 void updateLightDirection();
 
 // Ground plane VAO
@@ -115,8 +201,22 @@ unsigned int groundPlaneVAO = 0;
 unsigned int groundPlaneVBO = 0;
 unsigned int groundPlaneTexture = 0; // Dedicated ground texture
 
-int main()
+int main(int argc, char** argv)
 {
+    // CPU-only city benchmark: --bench-city [buildingCount]
+    if (argc > 1 && std::string(argv[1]) == "--bench-city")
+    {
+        size_t buildingCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+        return RunCityBenchmark(buildingCount);
+    }
+
+    // --no-shader-cache: compile every program from source (uncached timing runs)
+    bool useShaderCache = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--no-shader-cache") useShaderCache = false;
+    }
+
     // Initialize GLFW
     if (!glfwInit())
     {
@@ -149,6 +249,9 @@ int main()
         return -1;
     }
 
+    // Fresh context: the state tracker knows nothing yet
+    GLState::Invalidate();
+
     std::cout << "\n====================================================" << std::endl;
     std::cout << "|  PHASE 6 - LAB2 INTEGRATION + PROCEDURAL CITY   |" << std::endl;
     std::cout << "|  (Textured Buildings + Atlas Skybox)            |" << std::endl;
@@ -171,6 +274,7 @@ int main()
     std::cout << "  +/-  - Exposure adjust" << std::endl;
     std::cout << "  [/]  - Bloom strength" << std::endl;
     std::cout << "  T/G  - Bloom threshold" << std::endl;
+    std::cout << "  L    - Bloom blur: dual filter / Gaussian (logs GPU time)" << std::endl;
     std::cout << "  V    - Cycle debug views" << std::endl;
     std::cout << "  F4   - Toggle Gamma" << std::endl;
     std::cout << "\n  PHASE 6 (LAB2):" << std::endl;
@@ -178,28 +282,58 @@ int main()
     std::cout << "  K    - Toggle Skybox (Cubemap/Atlas)" << std::endl;
     std::cout << "\n  SHADOWS:" << std::endl;
     std::cout << "  F1 - Toggle shadows" << std::endl;
-    std::cout << "  F2 - Toggle PCF (soft shadows)" << std::endl;
+    std::cout << "  F2 - Cycle shadow filter (Hard / PCF / EVSM)" << std::endl;
     std::cout << "  F3 - Toggle depth map debug" << std::endl;
+    std::cout << "  F10 - Cycle PCF kernel (logs scene GPU time)" << std::endl;
+    std::cout << "  N - Animate sun (day/night sweep)" << std::endl;
+    std::cout << "  M - Amortised cascade updates (far cascades every 2nd/4th frame)" << std::endl;
+    std::cout << "\n  PERFORMANCE:" << std::endl;
+    std::cout << "  F11 - Frame-time governor (scales quality to the target)" << std::endl;
+    std::cout << "  F12 - Cycle governor target (60/30/90/120 Hz)" << std::endl;
     std::cout << "  Arrow Keys/[/] - Adjust light" << std::endl;
     std::cout << "===================================" << std::endl;
 
-    std::cout << "Shadow Map Resolution: " << SHADOW_WIDTH << "x" << SHADOW_HEIGHT << std::endl;
+    std::cout << "Shadow Map: " << SHADOW_CASCADE_COUNT << " cascades of " << SHADOW_RESOLUTION << "x" << SHADOW_RESOLUTION << std::endl;
     std::cout << "\n=== Phase 5: HDR + Tone Mapping + Bloom ===\n" << std::endl;
 
     // Enable depth testing
 
-    glEnable(GL_DEPTH_TEST);
+    GLState::Enable(GL_DEPTH_TEST);
+
+    // Program binary cache; must be ready before the first shader is loaded
+    ShaderCache::Initialize("shader_cache", useShaderCache);
+
+    // Per-frame uniform buffer; created first so programs bind its block at link time
+    FrameUniforms frameUniforms;
+    frameUniforms.Initialize();
 
     // Build and compile shader programs
     std::cout << "Loading shaders..." << std::endl;
     
-    // Phase 3 shaders
-    unsigned int modelShader = createShaderProgram("shaders/model.vert", "shaders/model.frag");
-    unsigned int skyboxShader = createShaderProgram("shaders/skybox.vert", "shaders/skybox.frag");
-    unsigned int shadowShader = createShaderProgram("shaders/shadow_depth.vert", "shaders/shadow_depth.frag");
-    unsigned int debugDepthShader = createShaderProgram("shaders/debug_depth.vert", "shaders/debug_depth.frag");
-
-    if (modelShader == 0 || skyboxShader == 0 || shadowShader == 0 || debugDepthShader == 0)
+    // Phase 3 shaders (uniforms are reflected once at link time)
+    // The lit model program is built per feature set; constant state is set
+    // once on each variant when it is first linked
+    ShaderVariants modelVariants;
+    Shader skyboxShader;
+    Shader shadowShader;
+    Shader debugDepthShader;
+    bool modelLoaded = modelVariants.Load("shaders/model.vert", "shaders/model.frag",
+        { "SHADOWS", "SHADOWS_PCF", "GAMMA_CORRECTION",
+          "PCF_TAPS_4", "PCF_TAPS_9", "PCF_TAPS_16", "PCF_POISSON", "PCF_LEGACY_LOOP", "SHADOWS_EVSM",
+          "AMBIENT_OCCLUSION" },
+        [](const Shader& shader) {
+            shader.SetInt("shadowMap", 1);
+            shader.SetInt("ambientOcclusion", 2);
+            shader.SetFloat("material.shininess", 32.0f);
+        });
+    skyboxShader.LoadFromFiles("shaders/skybox.vert", "shaders/skybox.frag");
+    shadowShader.LoadFromFiles("shaders/shadow_depth.vert", "shaders/shadow_depth.frag");
+    // Depth prepass for SSAO: the lit vertex shader (invariant position) with no fragment work
+    Shader depthPrepassShader;
+    depthPrepassShader.LoadFromFiles("shaders/model.vert", "shaders/shadow_depth.frag");
+    debugDepthShader.LoadFromFiles("shaders/debug_depth.vert", "shaders/debug_depth.frag");
+
+    if (!modelLoaded || !skyboxShader.IsValid() || !shadowShader.IsValid() || !debugDepthShader.IsValid())
     {
         std::cerr << "Failed to create shader programs" << std::endl;
         glfwTerminate();
@@ -220,10 +354,25 @@ int main()
     // Phase 6: Initialize City and SkyboxAtlas
     std::cout << "Loading Phase 6 components..." << std::endl;
     
-    unsigned int buildingShader = createShaderProgram("shaders/building.vert", "shaders/building.frag");
-    unsigned int skyboxAtlasShader = createShaderProgram("shaders/skybox_atlas.vert", "shaders/skybox_atlas.frag");
+    // Buildings have no gamma path, so that bit is ignored for their variants
+    ShaderVariants buildingVariants;
+    Shader buildingShadowShader;
+    Shader skyboxAtlasShader;
+    bool buildingLoaded = buildingVariants.Load("shaders/building.vert", "shaders/building.frag",
+        { "SHADOWS", "SHADOWS_PCF", "",
+          "PCF_TAPS_4", "PCF_TAPS_9", "PCF_TAPS_16", "PCF_POISSON", "PCF_LEGACY_LOOP", "SHADOWS_EVSM",
+          "AMBIENT_OCCLUSION" },
+        [](const Shader& shader) {
+            shader.SetInt("buildingTextures", 0);
+            shader.SetInt("shadowMap", 1);
+            shader.SetInt("ambientOcclusion", 2);
+        });
+    buildingShadowShader.LoadFromFiles("shaders/building_shadow.vert", "shaders/shadow_depth.frag");
+    Shader buildingPrepassShader;
+    buildingPrepassShader.LoadFromFiles("shaders/building.vert", "shaders/shadow_depth.frag");
+    skyboxAtlasShader.LoadFromFiles("shaders/skybox_atlas.vert", "shaders/skybox_atlas.frag");
     
-    if (buildingShader == 0 || skyboxAtlasShader == 0)
+    if (!buildingLoaded || !buildingShadowShader.IsValid() || !skyboxAtlasShader.IsValid())
     {
         std::cerr << "Failed to create Phase 6 shader programs" << std::endl;
         glfwTerminate();
@@ -231,9 +380,21 @@ int main()
     }
     
     City city;
-    city.Initialize(buildingShader);
+    city.Initialize();
     std::cout << "[OK] City system initialized\n" << std::endl;
     
+    // Warm the default variants so the first frame does not stall on a compile
+    uint32_t startupFeatures = FEATURE_SHADOWS | FEATURE_PCF | shadowFilterFeatures(shadowFilter);
+    if (!modelVariants.Get(startupFeatures).IsValid() || !buildingVariants.Get(startupFeatures).IsValid())
+    {
+        std::cerr << "Failed to compile default scene shader variants" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    
+    // All programs exist now (scene, HUD, post-processing): report cold vs cached cost
+    ShaderCache::LogStartupStats();
+    
     SkyboxAtlas* skyboxAtlas = new SkyboxAtlas();
     bool atlasAvailable = skyboxAtlas->LoadFromAtlas("assets/skybox/skybox_atlas.jpg");
     
@@ -246,7 +407,26 @@ int main()
     std::cout << "[OK] Skybox atlas system initialized (Available: " << (atlasAvailable ? "YES" : "NO - using fallback") << ")\n" << std::endl;
 
     // Create shadow map
-    ShadowMap shadowMap(SHADOW_WIDTH, SHADOW_HEIGHT);
+    ShadowMap shadowMap(SHADOW_RESOLUTION, SHADOW_CASCADE_COUNT);
+
+    // GPU time of the main scene pass, averaged per PCF kernel (F10)
+    GpuTimer scenePassTimer;
+    scenePassTimer.Initialize();
+    GpuTimer depthPrepassTimer;
+    depthPrepassTimer.Initialize();
+
+    // SSAO is optional: without its programs H does nothing
+    bool ambientOcclusionAvailable = postProcessor.IsAmbientOcclusionAvailable() &&
+                                     depthPrepassShader.IsValid() && buildingPrepassShader.IsValid();
+    int timedShadowFilter = shadowFilter;
+
+    // Whole-frame GPU time drives the quality level (only applied while F11 is on)
+    FrameGovernor governor;
+    governor.Initialize();
+
+    // What the cached static shadow layers were rendered with
+    unsigned int shadowCityRevision = city.GetContentRevision();
+    bool shadowCityEnabled = enableCity;
 
     // Load model
     std::cout << "Loading model..." << std::endl;
@@ -318,9 +498,26 @@ int main()
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
 
+    // GL state calls of the previous complete frame (HUD included)
+    GLStateStats lastFrameGLStats;
+
     // Render loop
     while (!glfwWindowShouldClose(window))
     {
+        lastFrameGLStats = GLState::GetStats();
+        GLState::ResetStats();
+        governor.BeginFrame();
+
+        // F10 switched kernels: report the previous one before measuring the next
+        if (timedShadowFilter != shadowFilter)
+        {
+            std::cout << "[Shadow] " << SHADOW_FILTER_NAMES[timedShadowFilter] << ": scene pass "
+                      << scenePassTimer.GetAverageMs() << " ms avg over "
+                      << scenePassTimer.GetSampleCount() << " frames" << std::endl;
+            scenePassTimer.ResetAverage();
+            timedShadowFilter = shadowFilter;
+        }
+
         // Calculate delta time
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
@@ -335,48 +532,136 @@ int main()
         processInput(window, camera, deltaTime);
         processDebugKeys(window, skyboxAtlas);
         processLightControls(window);
+        
+        // Day/night sweep: the shadow cascades follow it (amortised when M is on)
+        if (animateSun && !animationPaused)
+        {
+            lightAzimuth = std::fmod(lightAzimuth + SUN_SPEED * deltaTime, 360.0f);
+            updateLightDirection();
+        }
 
         // Update FPS
         updateFPS(window);
 
+        // Phase 6: Stream city chunks around the camera (generation runs on worker threads)
+        if (enableCity)
+        {
+            city.UpdateChunks(camera.Position);
+            city.SetCullingEnabled(enableCityCulling);
+        }
+
+        // Governor settings for this frame (full quality while it is off); the
+        // render targets are reallocated only when a level actually changes
+        governor.SetEnabled(enableGovernor);
+        governor.SetTargetMs(GOVERNOR_TARGETS_MS[governorTarget]);
+        const QualityLevel& quality = governor.GetSettings();
+        // Temporal upsampling caps the render scale; the governor can lower it further
+        float renderScale = quality.renderScale;
+        if (temporalMode > 0)
+        {
+            renderScale = std::min(renderScale, TEMPORAL_SCALES[temporalMode - 1]);
+        }
+        postProcessor.SetRenderScale(renderScale);
+        postProcessor.SetBloomLevels(quality.bloomLevels);
+        shadowMap.SetResolution(SHADOW_RESOLUTION >> quality.shadowResolutionShift);
+        int activeShadowFilter = governedShadowFilter(shadowFilter, quality.maxPcfTaps);
+
         // Phase 5: Begin post-processing render (if enabled AND not in debug mode)
         bool usePostProcessing = enablePostProcessing && postProcessor.IsInitialized() && !showDepthMap;
         if (usePostProcessing) {
             postProcessor.BeginRender();
         }
+        bool useTemporal = usePostProcessing && temporalMode > 0;
+        postProcessor.SetTemporalUpsampling(useTemporal);
+
+        // Pick the compiled permutation for the current toggles (compiled on first use)
+        uint32_t sceneFeatures = 0;
+        if (enableShadows)
+        {
+            sceneFeatures |= FEATURE_SHADOWS;
+            if (shadowMode == SHADOW_MODE_PCF) sceneFeatures |= FEATURE_PCF | shadowFilterFeatures(activeShadowFilter);
+            if (shadowMode == SHADOW_MODE_EVSM) sceneFeatures |= FEATURE_EVSM;
+        }
+        if (enableGammaCorrection) sceneFeatures |= FEATURE_GAMMA;
+        // SSAO reads the HDR target's depth, so it needs post-processing
+        bool useAmbientOcclusion = enableAmbientOcclusion && ambientOcclusionAvailable && usePostProcessing;
+        if (useAmbientOcclusion) sceneFeatures |= FEATURE_AMBIENT_OCCLUSION;
+        const Shader& modelShader = modelVariants.Get(sceneFeatures);
+        const Shader& buildingShader = buildingVariants.Get(sceneFeatures);
 
         // === PASS 1: SHADOW MAP (DEPTH PASS) ===
         // CRITICAL: Shadow pass must NOT affect the current framebuffer clear
         
-        // Light space matrix (orthographic for directional light)
-        // Use the global lightDirection variable
-        // EXPANDED: Larger frustum to cover city buildings
-        float near_plane = 0.5f, far_plane = 50.0f;  // Increased from 10.0f to 50.0f
-        glm::mat4 lightProjection = glm::ortho(-50.0f, 50.0f, -50.0f, 50.0f, near_plane, far_plane);  // Expanded from -5/-5 to -50/-50
-        glm::mat4 lightView = glm::lookAt(
-            -lightDirection * 25.0f,  // Increased from 5.0f to 25.0f
-            glm::vec3(0.0f, 0.0f, 0.0f),
-            glm::vec3(0.0f, 1.0f, 0.0f)
-        );
-        glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-        // Render scene to shadow map
-        shadowMap.BindForWriting();
-        glCullFace(GL_FRONT);
-        glUseProgram(shadowShader);
-        glUniformMatrix4fv(glGetUniformLocation(shadowShader, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-
-        // Render ground plane
+        // Camera matrices
+        float aspectRatio = (float)SCR_WIDTH / (float)SCR_HEIGHT;
+        glm::mat4 projection = camera.GetProjectionMatrix(aspectRatio);
+        glm::mat4 view = camera.GetViewMatrix();
+
+        // Temporal upsampling: shift the scene projection by a sub-pixel offset
+        // of the render target each frame; culling keeps the unjittered matrix
+        if (useTemporal)
+        {
+            camera.SetJitterSample(temporalFrame++, postProcessor.GetRenderWidth(), postProcessor.GetRenderHeight());
+        }
+        else
+        {
+            camera.Jitter = glm::vec2(0.0f);
+        }
+        postProcessor.SetCameraMatrices(projection * view, camera.Jitter);
+
+        // Static shadow layers are keyed on the city contents (the light is checked in Update)
+        if (city.GetContentRevision() != shadowCityRevision || enableCity != shadowCityEnabled)
+        {
+            shadowMap.InvalidateStatic();
+            shadowCityRevision = city.GetContentRevision();
+            shadowCityEnabled = enableCity;
+        }
+
+        // Ground plane (+/-50, cubes stand on it) plus the resident city bound
+        // every caster and receiver, so the cascades are clipped to them
+        glm::vec3 sceneBoundsMin(-50.0f, 0.0f, -50.0f);
+        glm::vec3 sceneBoundsMax(50.0f, 3.0f, 50.0f);
+        if (enableCity && city.GetBuildingCount() > 0)
+        {
+            sceneBoundsMin = glm::min(sceneBoundsMin, city.GetBoundsMin());
+            sceneBoundsMax = glm::max(sceneBoundsMax, city.GetBoundsMax());
+        }
+        shadowMap.SetSceneBounds(sceneBoundsMin, sceneBoundsMax);
+
+        // Split the camera frustum and fit one orthographic light matrix per cascade
+        // (only the cascades due this frame when updates are amortised)
+        for (int i = 0; i < shadowMap.GetCascadeCount(); ++i)
+        {
+            shadowMap.SetUpdateInterval(i, amortizeShadows ? SHADOW_UPDATE_INTERVALS[i] : 1);
+        }
+        shadowMap.Update(camera, aspectRatio, lightDirection);
+
+        // Everything the scene programs share goes up once, in one buffer
+        FrameData frameData;
+        frameData.view = view;
+        frameData.projection = camera.GetJitteredProjectionMatrix(aspectRatio);
+        for (int i = 0; i < shadowMap.GetCascadeCount(); ++i)
+        {
+            frameData.lightSpaceMatrices[i] = shadowMap.GetLightSpaceMatrix(i);
+            frameData.cascadeSplits[i] = shadowMap.GetSplitDistance(i);
+        }
+        frameData.cascadeCount = shadowMap.GetCascadeCount();
+        frameData.viewPos = glm::vec4(camera.Position, 1.0f);
+        frameData.dirLightDir = glm::vec4(lightDirection, 0.0f);
+        frameData.dirLightColor = glm::vec4(dirLightColor, 1.0f);
+        frameData.pointLightPos = glm::vec4(pointLightPos, 1.0f);
+        frameData.pointLightColor = glm::vec4(pointLightColor, 1.0f);
+        frameData.pointLightAttenuation = glm::vec4(1.0f, 0.09f, 0.032f, 0.0f);
+        frameUniforms.Update(frameData);
+
+        // Scene object transforms (shared by the shadow and main passes)
         glm::mat4 groundModel = glm::mat4(1.0f);
         groundModel = glm::scale(groundModel, glm::vec3(10.0f, 1.0f, 10.0f));
-        renderGroundPlane(shadowShader, groundModel);
 
-        // Render main animated cube (center)
+        // Main animated cube (center)
         glm::mat4 cubeModel = glm::mat4(1.0f);
         cubeModel = glm::translate(cubeModel, glm::vec3(0.0f, 1.5f, 0.0f));
         cubeModel = glm::rotate(cubeModel, cubeRotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
-        glUniformMatrix4fv(glGetUniformLocation(shadowShader, "model"), 1, GL_FALSE, glm::value_ptr(cubeModel));
-        model->Draw(shadowShader);
 
         // Phase 4: Add extra cubes for better shadow demonstration
         // Cube 2 (left)
@@ -384,181 +669,215 @@ int main()
         cube2Model = glm::translate(cube2Model, glm::vec3(-3.0f, 1.0f, -2.0f));
         cube2Model = glm::rotate(cube2Model, cubeRotationAngle * 0.5f, glm::vec3(1.0f, 0.5f, 0.0f));
         cube2Model = glm::scale(cube2Model, glm::vec3(0.8f));
-        glUniformMatrix4fv(glGetUniformLocation(shadowShader, "model"), 1, GL_FALSE, glm::value_ptr(cube2Model));
-        model->Draw(shadowShader);
 
         // Cube 3 (right)
         glm::mat4 cube3Model = glm::mat4(1.0f);
         cube3Model = glm::translate(cube3Model, glm::vec3(3.0f, 0.8f, 1.0f));
         cube3Model = glm::rotate(cube3Model, cubeRotationAngle * -0.7f, glm::vec3(0.0f, 1.0f, 1.0f));
         cube3Model = glm::scale(cube3Model, glm::vec3(0.6f));
-        glUniformMatrix4fv(glGetUniformLocation(shadowShader, "model"), 1, GL_FALSE, glm::value_ptr(cube3Model));
-        model->Draw(shadowShader);
 
-        // Phase 6: Render city buildings in shadow pass
-        if (enableCity)
+        // Render scene into each cascade layer
+        GLState::CullFace(GL_FRONT);
+        size_t shadowCasterDraws = 0;
+        int staticShadowRefreshes = 0;
+        int shadowCascadesRendered = 0;
+        for (int cascade = 0; cascade < shadowMap.GetCascadeCount(); ++cascade)
         {
-            // CRITICAL: Buildings must cast shadows
-            // Use dedicated shadow rendering method for efficiency
-            city.RenderShadow(lightSpaceMatrix, shadowShader);
+            // Not scheduled: the layer and its (older) matrix stay as they are
+            if (!shadowMap.IsCascadeDue(cascade))
+            {
+                continue;
+            }
+            shadowCascadesRendered++;
+
+            const glm::mat4& lightSpaceMatrix = shadowMap.GetLightSpaceMatrix(cascade);
+
+            // Static casters (ground, city) only when this cascade's cache is stale
+            if (!shadowMap.IsStaticValid(cascade))
+            {
+                shadowMap.BindStaticForWriting(cascade);
+                shadowShader.Use();
+                shadowShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
+
+                renderGroundPlane(shadowShader, groundModel);
+
+                // Phase 6: Render city buildings in shadow pass
+                if (enableCity)
+                {
+                    // CRITICAL: Buildings must cast shadows
+                    // Culled against this cascade's light volume, then one instanced draw
+                    city.RenderShadow(lightSpaceMatrix, buildingShadowShader);
+                    shadowCasterDraws += city.GetShadowCullStats().buildingsVisible;
+                }
+                staticShadowRefreshes++;
+            }
+
+            // Dynamic casters on top of the cached static depth
+            shadowMap.BindForWriting(cascade);
+            shadowShader.Use();
+            shadowShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
+
+            shadowShader.SetMat4("model", cubeModel);
+            model->Draw(shadowShader);
+            shadowShader.SetMat4("model", cube2Model);
+            model->Draw(shadowShader);
+            shadowShader.SetMat4("model", cube3Model);
+            model->Draw(shadowShader);
+        }
+
+        // EVSM: turn the freshly rendered depth layers into prefiltered moments
+        if ((sceneFeatures & FEATURE_EVSM) && postProcessor.IsInitialized())
+        {
+            shadowMap.UpdateMoments(postProcessor);
+        }
+        else
+        {
+            shadowMap.InvalidateMoments();
         }
 
         shadowMap.Unbind();
-        glCullFace(GL_BACK);
+        GLState::CullFace(GL_BACK);
+        // The HDR target bound by BeginRender() needs its viewport back (scaled by the governor)
+        GLState::Viewport(0, 0, postProcessor.GetRenderWidth(), postProcessor.GetRenderHeight());
 
         // === PASS 2: MAIN RENDER OR DEBUG VIEW ===
         
         // Set up the target framebuffer for scene rendering
         if (!usePostProcessing) {
             // Render directly to screen
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+            GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+            GLState::Viewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
             glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glEnable(GL_DEPTH_TEST);
+            GLState::Enable(GL_DEPTH_TEST);
         }
         // If using post-processing, HDR FBO is already bound by BeginRender()
 
         if (showDepthMap)
         {
             // Debug: Show depth map
-            glDisable(GL_DEPTH_TEST);
-            glUseProgram(debugDepthShader);
+            GLState::Disable(GL_DEPTH_TEST);
+            debugDepthShader.Use();
             
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, shadowMap.GetDepthTexture());
-            glUniform1i(glGetUniformLocation(debugDepthShader, "shadowMap"), 0);
+            // Nearest cascade (most detail), read as plain depth
+            shadowMap.BindForReading(GL_TEXTURE0, true);
+            debugDepthShader.SetInt("shadowMap", 0);
+            debugDepthShader.SetInt("cascade", 0);
             
             renderQuad();
+            GLState::BindSampler(0, 0);
             
-            glEnable(GL_DEPTH_TEST);
+            GLState::Enable(GL_DEPTH_TEST);
         }
         else
         {
-            // Normal rendering
-            
-            // Matrices
-            glm::mat4 projection = camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT);
-            glm::mat4 view = camera.GetViewMatrix();
+            // SSAO needs the scene depth before lighting: lay it down with a
+            // depth-only pass, then the lit pass re-tests against equal depth
+            // (which also keeps it from shading hidden fragments)
+            GLenum sceneDepthFunc = GL_LESS;
+            if (useAmbientOcclusion)
+            {
+                depthPrepassTimer.Begin();
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                depthPrepassShader.Use();
+                renderGroundPlane(depthPrepassShader, groundModel);
+                depthPrepassShader.SetMat4("model", cubeModel);
+                model->Draw(depthPrepassShader);
+                depthPrepassShader.SetMat4("model", cube2Model);
+                model->Draw(depthPrepassShader);
+                depthPrepassShader.SetMat4("model", cube3Model);
+                model->Draw(depthPrepassShader);
+                if (enableCity)
+                {
+                    city.Render(view, projection, buildingPrepassShader);
+                }
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                depthPrepassTimer.End();
+
+                // Half-resolution occlusion from that depth; the scene variants read it on unit 2
+                postProcessor.ComputeAmbientOcclusion(frameData.projection);
+                GLState::ActiveTexture(GL_TEXTURE2);
+                GLState::BindTexture(GL_TEXTURE_2D, postProcessor.GetAmbientOcclusionTexture());
+                sceneDepthFunc = GL_LEQUAL;
+                GLState::DepthFunc(sceneDepthFunc);
+            }
+
+            // Normal rendering (view/projection/lights come from the FrameData UBO)
+            scenePassTimer.Begin();
 
             // Render skybox first (choose mode)
             if (useSkyboxAtlas && skyboxAtlas->IsInitialized())
             {
                 // Lab2-style atlas skybox
-                glDepthFunc(GL_LEQUAL);
-                glUseProgram(skyboxAtlasShader);
-                glm::mat4 skyboxView = glm::mat4(glm::mat3(view));
-                glUniformMatrix4fv(glGetUniformLocation(skyboxAtlasShader, "view"), 1, GL_FALSE, glm::value_ptr(skyboxView));
-                glUniformMatrix4fv(glGetUniformLocation(skyboxAtlasShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-                skyboxAtlas->Draw(skyboxAtlasShader);
-                glDepthFunc(GL_LESS);
+                GLState::DepthFunc(GL_LEQUAL);
+                skyboxAtlasShader.Use();
+                skyboxAtlas->Draw(skyboxAtlasShader.GetID());
+                GLState::DepthFunc(sceneDepthFunc);
             }
             else if (skybox)
             {
                 // Original cubemap skybox
-                glDepthFunc(GL_LEQUAL);
-                glUseProgram(skyboxShader);
-                glm::mat4 skyboxView = glm::mat4(glm::mat3(view));
-                glUniformMatrix4fv(glGetUniformLocation(skyboxShader, "view"), 1, GL_FALSE, glm::value_ptr(skyboxView));
-                glUniformMatrix4fv(glGetUniformLocation(skyboxShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-                skybox->Draw(skyboxShader);
-                glDepthFunc(GL_LESS);
+                GLState::DepthFunc(GL_LEQUAL);
+                skyboxShader.Use();
+                skybox->Draw(skyboxShader.GetID());
+                GLState::DepthFunc(sceneDepthFunc);
             }
 
             // Render scene with lighting and shadows
-            glUseProgram(modelShader);
+            modelShader.Use();
 
-            // Set matrices
-            glUniformMatrix4fv(glGetUniformLocation(modelShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-            glUniformMatrix4fv(glGetUniformLocation(modelShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(modelShader, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-
-            // Set lights (use global lightDirection variable)
-            glUniform3fv(glGetUniformLocation(modelShader, "dirLightDir"), 1, glm::value_ptr(lightDirection));
-            glUniform3fv(glGetUniformLocation(modelShader, "dirLightColor"), 1, glm::value_ptr(dirLightColor));
-            
-            glUniform3fv(glGetUniformLocation(modelShader, "pointLightPos"), 1, glm::value_ptr(pointLightPos));
-            glUniform3fv(glGetUniformLocation(modelShader, "pointLightColor"), 1, glm::value_ptr(pointLightColor));
-            glUniform1f(glGetUniformLocation(modelShader, "pointLightConstant"), 1.0f);
-            glUniform1f(glGetUniformLocation(modelShader, "pointLightLinear"), 0.09f);
-            glUniform1f(glGetUniformLocation(modelShader, "pointLightQuadratic"), 0.032f);
-
-            // Set camera
-            glUniform3fv(glGetUniformLocation(modelShader, "viewPos"), 1, glm::value_ptr(camera.Position));
-
-            // Set shadow map
-            shadowMap.BindForReading(GL_TEXTURE1);
-            glUniform1i(glGetUniformLocation(modelShader, "shadowMap"), 1);
-
-            // Set toggles
-            glUniform1i(glGetUniformLocation(modelShader, "enableShadows"), enableShadows);
-            glUniform1i(glGetUniformLocation(modelShader, "uUsePCF"), enablePCF);
-            glUniform1i(glGetUniformLocation(modelShader, "enableGammaCorrection"), enableGammaCorrection);
-
-            // Set material
-            glUniform1f(glGetUniformLocation(modelShader, "material.shininess"), 32.0f);
-            
-            // Set bloom threshold for MRT
-            glUniform1f(glGetUniformLocation(modelShader, "bloomThreshold"), bloomThreshold);
+            // Set shadow map (sampler unit is fixed at startup)
+            bindSceneShadows(shadowMap, sceneFeatures);
 
             // Render ground plane
             renderGroundPlane(modelShader, groundModel);
 
             // Render main animated cube
-            glUniformMatrix4fv(glGetUniformLocation(modelShader, "model"), 1, GL_FALSE, glm::value_ptr(cubeModel));
+            modelShader.SetMat4("model", cubeModel);
             model->Draw(modelShader);
 
             // Render extra cubes
-            glUniformMatrix4fv(glGetUniformLocation(modelShader, "model"), 1, GL_FALSE, glm::value_ptr(cube2Model));
+            modelShader.SetMat4("model", cube2Model);
             model->Draw(modelShader);
             
-            glUniformMatrix4fv(glGetUniformLocation(modelShader, "model"), 1, GL_FALSE, glm::value_ptr(cube3Model));
+            modelShader.SetMat4("model", cube3Model);
             model->Draw(modelShader);
             
             // Phase 6: Render city
             if (enableCity)
             {
-                glUseProgram(buildingShader);
-                
-                // Set matrices for buildings
-                glUniformMatrix4fv(glGetUniformLocation(buildingShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-                glUniformMatrix4fv(glGetUniformLocation(buildingShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-                glUniformMatrix4fv(glGetUniformLocation(buildingShader, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-                
-                // Set lights
-                glUniform3fv(glGetUniformLocation(buildingShader, "dirLightDir"), 1, glm::value_ptr(lightDirection));
-                glUniform3fv(glGetUniformLocation(buildingShader, "dirLightColor"), 1, glm::value_ptr(dirLightColor));
-                glUniform3fv(glGetUniformLocation(buildingShader, "pointLightPos"), 1, glm::value_ptr(pointLightPos));
-                glUniform3fv(glGetUniformLocation(buildingShader, "pointLightColor"), 1, glm::value_ptr(pointLightColor));
-                glUniform1f(glGetUniformLocation(buildingShader, "pointLightConstant"), 1.0f);
-                glUniform1f(glGetUniformLocation(buildingShader, "pointLightLinear"), 0.09f);
-                glUniform1f(glGetUniformLocation(buildingShader, "pointLightQuadratic"), 0.032f);
-                
-                // Set camera and shadow
-                glUniform3fv(glGetUniformLocation(buildingShader, "viewPos"), 1, glm::value_ptr(camera.Position));
-                shadowMap.BindForReading(GL_TEXTURE1);
-                glUniform1i(glGetUniformLocation(buildingShader, "shadowMap"), 1);
+                // Shadow map on unit 1; matrices and lights come from FrameData
+                bindSceneShadows(shadowMap, sceneFeatures);
                 
-                // Set toggles
-                glUniform1i(glGetUniformLocation(buildingShader, "enableShadows"), enableShadows);
-                glUniform1i(glGetUniformLocation(buildingShader, "uUsePCF"), enablePCF);
-                glUniform1f(glGetUniformLocation(buildingShader, "bloomThreshold"), bloomThreshold);
-                
-                // Render city
-                city.Render(view, projection, lightSpaceMatrix, camera.Position);
+                // Render city (the prepass already culled and streamed it this frame)
+                if (useAmbientOcclusion)
+                {
+                    city.RenderVisible(buildingShader);
+                }
+                else
+                {
+                    city.Render(view, projection, buildingShader);
+                }
             }
+            
+            scenePassTimer.End();
+            GLState::DepthFunc(GL_LESS);
         }
 
         // Phase 5: End post-processing render and apply effects (if it was started)
         if (usePostProcessing) {
             postProcessor.EndRender();
+            postProcessor.SetBloomMode(bloomMode);
+            postProcessor.SetBloomThreshold(bloomThreshold);
+            postProcessor.SetAutoExposure(enableAutoExposure);
+            postProcessor.UpdateExposure(deltaTime);
             postProcessor.Render(exposure, enableBloom, enableGammaCorrection, bloomStrength, debugViewMode);
         }
 
         // Phase 4: Render HUD overlay (always on top)
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::Disable(GL_DEPTH_TEST);
+        GLState::Enable(GL_BLEND);
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         float hudY = 580.0f;
         float hudScale = 1.3f;
@@ -577,11 +896,40 @@ int main()
         snprintf(expBuf, sizeof(expBuf), "Exposure: %.1f (+/-)", exposure);
         hud.RenderText(expBuf, 10.0f, hudY, hudScale, hudColor);
         hudY -= 18.0f;
+
+        const AutoExposure& autoExposure = postProcessor.GetAutoExposure();
+        char autoExpBuf[128];
+        if (enableAutoExposure) {
+            snprintf(autoExpBuf, sizeof(autoExpBuf), "Auto exposure: x%.2f (avg lum %.3f) (X)",
+                     autoExposure.GetExposure(), autoExposure.GetAverageLuminance());
+            hud.RenderText(autoExpBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+            hudY -= 18.0f;
+            snprintf(autoExpBuf, sizeof(autoExpBuf), "  GPU: %.2f ms  Readback: %.3f ms, %d frames late",
+                     autoExposure.GetGpuMs(), autoExposure.GetReadbackCpuMs(), autoExposure.GetReadbackLatency());
+        } else {
+            snprintf(autoExpBuf, sizeof(autoExpBuf), "Auto exposure: OFF (X)");
+        }
+        hud.RenderText(autoExpBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
         
         char bloomStrBuf[32];
         snprintf(bloomStrBuf, sizeof(bloomStrBuf), "Bloom Str: %.2f ([/])", bloomStrength);
         hud.RenderText(bloomStrBuf, 10.0f, hudY, hudScale, hudColor);
         hudY -= 18.0f;
+
+        char bloomModeBuf[96];
+        snprintf(bloomModeBuf, sizeof(bloomModeBuf), "Bloom blur: %s, %d levels  GPU: %.2f ms (L)",
+                 postProcessor.GetBloomModeName(), postProcessor.GetBloomLevels(), postProcessor.GetBloomGpuMs());
+        hud.RenderText(bloomModeBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+
+        const FrameGraph::Stats& graphStats = postProcessor.GetFrameGraphStats();
+        char graphBuf[96];
+        snprintf(graphBuf, sizeof(graphBuf), "Post passes: %d/%d (%d culled)  Targets: %.1f -> %.1f MB",
+                 graphStats.passCount - graphStats.culledPasses, graphStats.passCount, graphStats.culledPasses,
+                 graphStats.transientBytes / (1024.0 * 1024.0), graphStats.physicalBytes / (1024.0 * 1024.0));
+        hud.RenderText(graphBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
         
         char threshBuf[32];
         snprintf(threshBuf, sizeof(threshBuf), "Threshold: %.1f (T/G)", bloomThreshold);
@@ -596,6 +944,35 @@ int main()
         hud.RenderText("City: " + std::string(enableCity ? "ON" : "OFF") + " (C)", 10.0f, hudY, hudScale, hudColor);
         hudY -= 18.0f;
         
+        char chunkBuf[64];
+        snprintf(chunkBuf, sizeof(chunkBuf), "Chunks: %zu (+%zu pending)", 
+                 city.GetResidentChunkCount(), city.GetPendingChunkCount());
+        hud.RenderText(chunkBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+        
+        const CityCullStats& cullStats = city.GetCullStats();
+        char cullBuf[96];
+        snprintf(cullBuf, sizeof(cullBuf), "Culling: %s  Visible: %zu  Culled: %zu (F9)", 
+                 city.IsCullingEnabled() ? "ON" : "OFF", cullStats.buildingsVisible, cullStats.buildingsCulled);
+        hud.RenderText(cullBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+        
+        snprintf(cullBuf, sizeof(cullBuf), "Shadow casters: %zu drawn, static %d/%d cascades refreshed", 
+                 shadowCasterDraws, staticShadowRefreshes, shadowMap.GetCascadeCount());
+        hud.RenderText(cullBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+        
+        snprintf(cullBuf, sizeof(cullBuf), "Shadow updates: %d/%d cascades, %s (M)  Sun: %s (N)", 
+                 shadowCascadesRendered, shadowMap.GetCascadeCount(),
+                 amortizeShadows ? "amortised" : "every frame", animateSun ? "animated" : "manual");
+        hud.RenderText(cullBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+        
+        snprintf(cullBuf, sizeof(cullBuf), "GL state: %u issued / %u skipped", 
+                 lastFrameGLStats.issued, lastFrameGLStats.skipped);
+        hud.RenderText(cullBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+        
         std::string skyboxModeText = "Skybox: ";
         if (useSkyboxAtlas && skyboxAtlas->IsInitialized()) {
             skyboxModeText += "Atlas";
@@ -610,7 +987,46 @@ int main()
         
         hud.RenderText("Shadows: " + std::string(enableShadows ? "ON" : "OFF") + " (F1)", 10.0f, hudY, hudScale, hudColor);
         hudY -= 18.0f;
-        hud.RenderText("PCF: " + std::string(enablePCF ? "ON" : "OFF") + " (F2)", 10.0f, hudY, hudScale, hudColor);
+        hud.RenderText(std::string("Shadow filter: ") + SHADOW_MODE_NAMES[shadowMode] + " (F2)", 10.0f, hudY, hudScale, hudColor);
+        hudY -= 18.0f;
+        
+        char pcfBuf[80];
+        snprintf(pcfBuf, sizeof(pcfBuf), "Kernel: %s  Scene GPU: %.2f ms (F10)", 
+                 SHADOW_FILTER_NAMES[activeShadowFilter], scenePassTimer.GetLastMs());
+        hud.RenderText(pcfBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+
+        char governorBuf[128];
+        snprintf(governorBuf, sizeof(governorBuf), "Governor: %s  %s, target %.1f ms  GPU frame: %.2f ms (F11/F12)",
+                 enableGovernor ? "ON" : "OFF", quality.name, governor.GetTargetMs(), governor.GetLastMs());
+        hud.RenderText(governorBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+        snprintf(governorBuf, sizeof(governorBuf), "Render %ux%u  Shadow %u  PCF <= %d taps  Bloom %d levels",
+                 postProcessor.GetRenderWidth(), postProcessor.GetRenderHeight(), shadowMap.GetWidth(),
+                 std::min(quality.maxPcfTaps, SHADOW_FILTER_TAPS[shadowFilter]), postProcessor.GetBloomLevels());
+        hud.RenderText(governorBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+
+        char temporalBuf[112];
+        if (temporalMode > 0) {
+            snprintf(temporalBuf, sizeof(temporalBuf), "Temporal upsampling: %ux%u -> %ux%u  GPU: %.2f ms (U)",
+                     postProcessor.GetRenderWidth(), postProcessor.GetRenderHeight(), SCR_WIDTH, SCR_HEIGHT,
+                     postProcessor.GetTemporalGpuMs());
+        } else {
+            snprintf(temporalBuf, sizeof(temporalBuf), "Temporal upsampling: OFF (U)");
+        }
+        hud.RenderText(temporalBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
+        hudY -= 18.0f;
+
+        char ssaoBuf[96];
+        if (useAmbientOcclusion) {
+            snprintf(ssaoBuf, sizeof(ssaoBuf), "SSAO: %ux%u  GPU: %.2f ms  Depth prepass: %.2f ms (H)",
+                     postProcessor.GetRenderWidth() / 2, postProcessor.GetRenderHeight() / 2,
+                     postProcessor.GetAmbientOcclusionGpuMs(), depthPrepassTimer.GetLastMs());
+        } else {
+            snprintf(ssaoBuf, sizeof(ssaoBuf), "SSAO: OFF (H)");
+        }
+        hud.RenderText(ssaoBuf, 10.0f, hudY, hudScale * 0.9f, hudColor);
         hudY -= 18.0f;
         hud.RenderText("Gamma: " + std::string(enableGammaCorrection ? "ON" : "OFF") + " (F4)", 10.0f, hudY, hudScale, hudColor);
         hudY -= 18.0f;
@@ -629,8 +1045,9 @@ int main()
             hud.RenderText("[PAUSED]", 10.0f, hudY, hudScale, glm::vec3(1.0f, 1.0f, 0.0f));
         }
 
-        glDisable(GL_BLEND);
-        glEnable(GL_DEPTH_TEST);
+        GLState::Disable(GL_BLEND);
+        GLState::Enable(GL_DEPTH_TEST);
+        governor.EndFrame();
 
         // Swap buffers and poll events
         glfwSwapBuffers(window);
@@ -645,24 +1062,33 @@ int main()
     city.Cleanup();
     hud.Cleanup();
     postProcessor.Cleanup();
+    shadowMap.Cleanup();
+    scenePassTimer.Cleanup();
+    depthPrepassTimer.Cleanup();
+    governor.Cleanup();
     
     if (groundPlaneVAO != 0)
     {
-        glDeleteVertexArrays(1, &groundPlaneVAO);
+        GLState::DeleteVertexArrays(1, &groundPlaneVAO);
         glDeleteBuffers(1, &groundPlaneVBO);
     }
     
     if (groundPlaneTexture != 0)
     {
-        glDeleteTextures(1, &groundPlaneTexture);
+        GLState::DeleteTextures(1, &groundPlaneTexture);
     }
 
-    glDeleteProgram(modelShader);
-    glDeleteProgram(skyboxShader);
-    glDeleteProgram(shadowShader);
-    glDeleteProgram(debugDepthShader);
-    glDeleteProgram(buildingShader);
-    glDeleteProgram(skyboxAtlasShader);
+    // Delete programs while the context is still alive
+    modelVariants.Clear();
+    skyboxShader.Delete();
+    shadowShader.Delete();
+    debugDepthShader.Delete();
+    buildingVariants.Clear();
+    buildingShadowShader.Delete();
+    depthPrepassShader.Delete();
+    buildingPrepassShader.Delete();
+    skyboxAtlasShader.Delete();
+    frameUniforms.Cleanup();
 
     glfwTerminate();
     std::cout << "\n[OK] Application closed successfully" << std::endl;
@@ -728,7 +1154,7 @@ void processInput(GLFWwindow* window, Camera& camera, float deltaTime)
 // Callback for window resize
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    GLState::Viewport(0, 0, width, height);
 }
 
 // Mouse movement callback
@@ -771,100 +1197,6 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     }
 }
 
-std::string loadShaderFromFile(const char* filePath)
-{
-    std::ifstream shaderFile;
-    std::stringstream shaderStream;
-
-    shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try
-    {
-        shaderFile.open(filePath);
-        shaderStream << shaderFile.rdbuf();
-        shaderFile.close();
-        return shaderStream.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
-        std::cerr << "ERROR: Failed to read shader file: " << filePath << std::endl;
-        return "";
-    }
-}
-
-// Compile a shader and check for errors
-unsigned int compileShader(unsigned int type, const char* source)
-{
-    unsigned int shader = glCreateShader(type);
-    glShaderSource(shader, 1, &source, NULL);
-    glCompileShader(shader);
-
-    // Check for compilation errors
-    int success;
-    char infoLog[1024];
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-        const char* shaderType = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
-        std::cerr << "ERROR: " << shaderType << " Shader compilation failed\n" << infoLog << std::endl;
-        return 0;
-    }
-
-    return shader;
-}
-
-// Create shader program from vertex and fragment shader files
-unsigned int createShaderProgram(const char* vertexPath, const char* fragmentPath)
-{
-    // Load shader source code
-    std::string vertexCode = loadShaderFromFile(vertexPath);
-    std::string fragmentCode = loadShaderFromFile(fragmentPath);
-
-    if (vertexCode.empty() || fragmentCode.empty())
-    {
-        std::cerr << "ERROR: Failed to load shader files: " << vertexPath << " or " << fragmentPath << std::endl;
-        return 0;
-    }
-
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    // Compile shaders
-    std::cout << "Compiling shaders: " << vertexPath << ", " << fragmentPath << std::endl;
-    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vShaderCode);
-    unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fShaderCode);
-
-    if (vertexShader == 0 || fragmentShader == 0)
-    {
-        std::cerr << "ERROR: Shader compilation failed for: " << vertexPath << " or " << fragmentPath << std::endl;
-        return 0;
-    }
-
-    // Link shaders into program
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    // Check for linking errors
-    int success;
-    char infoLog[1024];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 1024, NULL, infoLog);
-        std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
-        return 0;
-    }
-
-    // Delete shaders (no longer needed after linking)
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    std::cout << "[OK] Shaders compiled and linked: " << vertexPath << ", " << fragmentPath << std::endl;
-    return shaderProgram;
-}
-
 // Update FPS counter in window title (once per second)
 void updateFPS(GLFWwindow* window)
 {
@@ -900,7 +1232,7 @@ void renderQuad()
         
         glGenVertexArrays(1, &quadVAO);
         glGenBuffers(1, &quadVBO);
-        glBindVertexArray(quadVAO);
+        GLState::BindVertexArray(quadVAO);
         glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
         
@@ -913,16 +1245,15 @@ void renderQuad()
         glEnableVertexAttribArray(1);
         
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
     }
 
-    glBindVertexArray(quadVAO);
+    GLState::BindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
 }
 
 // Render the ground plane
-void renderGroundPlane(unsigned int shader, const glm::mat4& model)
+void renderGroundPlane(const Shader& shader, const glm::mat4& model)
 {
     // Create ground texture once from file
     if (groundPlaneTexture == 0)
@@ -960,7 +1291,7 @@ void renderGroundPlane(unsigned int shader, const glm::mat4& model)
                     format = GL_RGBA;
                 
                 glGenTextures(1, &groundPlaneTexture);
-                glBindTexture(GL_TEXTURE_2D, groundPlaneTexture);
+                GLState::BindTexture(GL_TEXTURE_2D, groundPlaneTexture);
                 glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
                 glGenerateMipmap(GL_TEXTURE_2D);
                 
@@ -1019,7 +1350,7 @@ void renderGroundPlane(unsigned int shader, const glm::mat4& model)
             }
             
             glGenTextures(1, &groundPlaneTexture);
-            glBindTexture(GL_TEXTURE_2D, groundPlaneTexture);
+            GLState::BindTexture(GL_TEXTURE_2D, groundPlaneTexture);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texSize, texSize, 0, GL_RGB, GL_UNSIGNED_BYTE, texData);
             glGenerateMipmap(GL_TEXTURE_2D);
             
@@ -1048,7 +1379,7 @@ void renderGroundPlane(unsigned int shader, const glm::mat4& model)
 
         glGenVertexArrays(1, &groundPlaneVAO);
         glGenBuffers(1, &groundPlaneVBO);
-        glBindVertexArray(groundPlaneVAO);
+        GLState::BindVertexArray(groundPlaneVAO);
         glBindBuffer(GL_ARRAY_BUFFER, groundPlaneVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 
@@ -1060,23 +1391,22 @@ void renderGroundPlane(unsigned int shader, const glm::mat4& model)
         glEnableVertexAttribArray(2);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
         
         std::cout << "[Ground] Ground plane geometry initialized (10x10 UV tiling)" << std::endl;
     }
 
     // CRITICAL: Bind ground texture to correct unit BEFORE drawing
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, groundPlaneTexture);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, groundPlaneTexture);
     
     // Set model matrix and draw
-    glBindVertexArray(groundPlaneVAO);
-    glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
+    GLState::BindVertexArray(groundPlaneVAO);
+    shader.SetMat4("model", model);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
 }
 
-// Process debug keys (F1-F8, B, O, V, T, G, C, K, +/-, [/])
+// Process debug keys (F1-F12, B, L, X, U, H, O, V, T, G, C, K, N, M, +/-, [/])
 void processDebugKeys(GLFWwindow* window, SkyboxAtlas* skyboxAtlas)
 {
     // F1: Toggle Shadows
@@ -1091,11 +1421,11 @@ void processDebugKeys(GLFWwindow* window, SkyboxAtlas* skyboxAtlas)
         f1Pressed = false;
     }
 
-    // F2: Toggle PCF
+    // F2: Cycle shadow filter mode
     if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS && !f2Pressed)
     {
-        enablePCF = !enablePCF;
-        std::cout << "PCF " << (enablePCF ? "ENABLED" : "DISABLED") << std::endl;
+        shadowMode = (shadowMode + 1) % SHADOW_MODE_COUNT;
+        std::cout << "Shadow filter: " << SHADOW_MODE_NAMES[shadowMode] << std::endl;
         f2Pressed = true;
     }
     else if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_RELEASE)
@@ -1151,6 +1481,57 @@ void processDebugKeys(GLFWwindow* window, SkyboxAtlas* skyboxAtlas)
         bPressed = false;
     }
 
+    // L: Switch bloom blur between the dual-filter mip chain and the Gaussian ping-pong
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS && !lPressed)
+    {
+        bloomMode = (bloomMode == BLOOM_DUAL_FILTER) ? BLOOM_GAUSSIAN : BLOOM_DUAL_FILTER;
+        std::cout << "Bloom blur: " << (bloomMode == BLOOM_DUAL_FILTER ? "Dual filter" : "Gaussian") << std::endl;
+        lPressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_L) == GLFW_RELEASE)
+    {
+        lPressed = false;
+    }
+
+    // X: Toggle automatic exposure (average scene luminance, read back asynchronously)
+    if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS && !xPressed)
+    {
+        enableAutoExposure = !enableAutoExposure;
+        std::cout << "Auto exposure " << (enableAutoExposure ? "ENABLED" : "DISABLED") << std::endl;
+        xPressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_X) == GLFW_RELEASE)
+    {
+        xPressed = false;
+    }
+
+    // U: Cycle temporal upsampling (off, 100%, 75%, 50% render scale)
+    if (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS && !uPressed)
+    {
+        temporalMode = (temporalMode + 1) % (TEMPORAL_SCALE_COUNT + 1);
+        if (temporalMode == 0)
+            std::cout << "Temporal upsampling DISABLED" << std::endl;
+        else
+            std::cout << "Temporal upsampling from " << TEMPORAL_SCALES[temporalMode - 1] * 100.0f << "% render scale" << std::endl;
+        uPressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_U) == GLFW_RELEASE)
+    {
+        uPressed = false;
+    }
+
+    // H: Toggle SSAO on the ambient term (depth prepass + half-resolution occlusion)
+    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS && !hPressed)
+    {
+        enableAmbientOcclusion = !enableAmbientOcclusion;
+        std::cout << "SSAO " << (enableAmbientOcclusion ? "ENABLED" : "DISABLED") << std::endl;
+        hPressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_H) == GLFW_RELEASE)
+    {
+        hPressed = false;
+    }
+
     // D: Cycle Debug Views
     if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS && !vPressed)  // Changed from D to V
     {
@@ -1282,6 +1663,30 @@ void processDebugKeys(GLFWwindow* window, SkyboxAtlas* skyboxAtlas)
         kPressed = false;
     }
 
+    // N: Animate the sun
+    if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS && !nPressed)
+    {
+        animateSun = !animateSun;
+        std::cout << "Sun animation " << (animateSun ? "ON" : "OFF") << std::endl;
+        nPressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_N) == GLFW_RELEASE)
+    {
+        nPressed = false;
+    }
+
+    // M: Amortised (round-robin) shadow cascade updates
+    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS && !mPressed)
+    {
+        amortizeShadows = !amortizeShadows;
+        std::cout << "Amortised shadow updates " << (amortizeShadows ? "ON" : "OFF") << std::endl;
+        mPressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_M) == GLFW_RELEASE)
+    {
+        mPressed = false;
+    }
+
     // Legacy F5-F8 keys still work
     if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS && !f5Pressed)
     {
@@ -1327,6 +1732,95 @@ void processDebugKeys(GLFWwindow* window, SkyboxAtlas* skyboxAtlas)
     {
         f8Pressed = false;
     }
+
+    // F9: Toggle city frustum culling
+    if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS && !f9Pressed)
+    {
+        enableCityCulling = !enableCityCulling;
+        std::cout << "Frustum Culling " << (enableCityCulling ? "ENABLED" : "DISABLED") << std::endl;
+        f9Pressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_RELEASE)
+    {
+        f9Pressed = false;
+    }
+
+    // F10: Cycle PCF kernel (the frame loop logs the GPU time of the previous one)
+    if (glfwGetKey(window, GLFW_KEY_F10) == GLFW_PRESS && !f10Pressed)
+    {
+        shadowFilter = (shadowFilter + 1) % SHADOW_FILTER_COUNT;
+        std::cout << "Shadow filter: " << SHADOW_FILTER_NAMES[shadowFilter] << std::endl;
+        f10Pressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_F10) == GLFW_RELEASE)
+    {
+        f10Pressed = false;
+    }
+
+    // F11: Toggle the frame-time governor (off restores full quality)
+    if (glfwGetKey(window, GLFW_KEY_F11) == GLFW_PRESS && !f11Pressed)
+    {
+        enableGovernor = !enableGovernor;
+        std::cout << "Frame-time governor " << (enableGovernor ? "ENABLED" : "DISABLED") << std::endl;
+        f11Pressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_F11) == GLFW_RELEASE)
+    {
+        f11Pressed = false;
+    }
+
+    // F12: Cycle the governor's target frame time
+    if (glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS && !f12Pressed)
+    {
+        governorTarget = (governorTarget + 1) % GOVERNOR_TARGET_COUNT;
+        std::cout << "Governor target: " << GOVERNOR_TARGETS_MS[governorTarget] << " ms" << std::endl;
+        f12Pressed = true;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_F12) == GLFW_RELEASE)
+    {
+        f12Pressed = false;
+    }
+}
+
+// Shadow input of the scene variants on unit 1: moments for EVSM, otherwise the
+// depth array (raw for the legacy PCF loop, depth-compare for everything else)
+void bindSceneShadows(ShadowMap& shadowMap, uint32_t sceneFeatures)
+{
+    if (sceneFeatures & FEATURE_EVSM)
+    {
+        shadowMap.BindMomentsForReading(GL_TEXTURE1);
+    }
+    else
+    {
+        shadowMap.BindForReading(GL_TEXTURE1, (sceneFeatures & FEATURE_PCF_LEGACY) != 0);
+    }
+}
+
+// Shader feature bits for a PCF kernel (only added while PCF is enabled)
+uint32_t shadowFilterFeatures(int filter)
+{
+    switch (filter)
+    {
+    case SHADOW_FILTER_4_TAP:      return FEATURE_PCF_TAPS_4;
+    case SHADOW_FILTER_9_TAP:      return FEATURE_PCF_TAPS_9;
+    case SHADOW_FILTER_16_TAP:     return FEATURE_PCF_TAPS_16;
+    case SHADOW_FILTER_16_POISSON: return FEATURE_PCF_TAPS_16 | FEATURE_PCF_POISSON;
+    case SHADOW_FILTER_LEGACY_49:  return FEATURE_PCF_LEGACY;
+    default:                       return 0;  // 1 tap: a single hardware-filtered lookup
+    }
+}
+
+// Largest kernel within the governor's tap budget (the selected one if it fits)
+int governedShadowFilter(int filter, int maxTaps)
+{
+    if (SHADOW_FILTER_TAPS[filter] <= maxTaps) return filter;
+
+    const int fallbacks[] = { SHADOW_FILTER_16_TAP, SHADOW_FILTER_9_TAP, SHADOW_FILTER_4_TAP };
+    for (int fallback : fallbacks)
+    {
+        if (SHADOW_FILTER_TAPS[fallback] <= maxTaps) return fallback;
+    }
+    return SHADOW_FILTER_1_TAP;
 }
 
 // Update light direction based on azimuth and elevation